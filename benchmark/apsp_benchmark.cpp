@@ -0,0 +1,58 @@
+#include "gdwg/algorithms/all_pairs.hpp"
+#include "gdwg/frozen_graph.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// All-pairs shortest paths on a frozen graph with 2048 nodes and 4, 16, 64 or 256 edges per node
+// to random targets, by blocked Floyd-Warshall and by Johnson (Dijkstra from every node). The
+// automatic choice switches to Floyd-Warshall at 2048 / johnson_degree_ratio = 128 edges per node.
+
+namespace {
+	constexpr auto nodes = std::size_t{2048};
+
+	auto make_graph(std::size_t degree) -> gdwg::frozen_graph<int, int> {
+		auto names = std::vector<int>(nodes);
+		auto offsets = std::vector<std::size_t>{0};
+		auto targets = std::vector<gdwg::node_id>{};
+		auto weights = std::vector<int>{};
+		auto state = std::uint64_t{42};
+		auto row = std::vector<gdwg::node_id>(degree);
+		for (auto v = std::size_t{0}; v < nodes; ++v) {
+			names[v] = static_cast<int>(v);
+			for (auto& to : row) {
+				state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+				to = static_cast<gdwg::node_id>((state >> 33U) % nodes);
+			}
+			std::sort(row.begin(), row.end());
+			for (auto const to : row) {
+				targets.push_back(to);
+				weights.push_back(1 + static_cast<int>(to % 100));
+			}
+			offsets.push_back(targets.size());
+		}
+		return {std::move(names), std::move(offsets), std::move(targets), std::move(weights)};
+	}
+
+	auto run(benchmark::State& state, gdwg::algorithms::apsp_algorithm algorithm) -> void {
+		auto const g = make_graph(static_cast<std::size_t>(state.range(0)));
+		for (auto _ : state) {
+			auto const d = gdwg::algorithms::all_pairs_shortest_paths(g, algorithm);
+			benchmark::DoNotOptimize(d.distance.data());
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(nodes * nodes));
+	}
+
+	auto floyd_warshall(benchmark::State& state) -> void {
+		run(state, gdwg::algorithms::apsp_algorithm::floyd_warshall);
+	}
+
+	auto johnson(benchmark::State& state) -> void {
+		run(state, gdwg::algorithms::apsp_algorithm::johnson);
+	}
+} // namespace
+
+BENCHMARK(floyd_warshall)->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(johnson)->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,233 @@
+#include "gdwg/graph.hpp"
+
+#include <absl/container/btree_set.h>
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// The ordered set under graph's edges: std::set (the red-black tree graph used to keep them in)
+// against absl::btree_set (what it keeps them in now), holding 2^20 edges from 2^16 nodes.
+// Elements are laid out as graph keeps them, both ways: by value, as the inline edges of a
+// graph<int, int>, and as shared_ptrs to edges on the heap, as for a graph<std::string, ...>.
+// Lookups find one edge, scans walk all the out edges of one node, and inserts build the whole
+// set in random order. Then the same operations on a graph<int, int> of that size.
+
+namespace {
+	constexpr auto node_count = 1 << 16;
+	constexpr auto edges_per_node = 16;
+	constexpr auto batch = 4096; // lookups or scans per iteration, at random places in the set
+
+	// the layout of graph<int, int>::flat_edge
+	struct edge {
+		void const* from_ptr;
+		void const* to_ptr;
+		int from;
+		int to;
+		int weight;
+	};
+
+	auto get(edge const& e) -> edge const& {
+		return e;
+	}
+	auto get(std::shared_ptr<edge> const& e) -> edge const& {
+		return *e;
+	}
+
+	// all the edges from one node (graph::src_key)
+	struct src_key {
+		int from;
+	};
+
+	template<typename Edge>
+	struct edge_less {
+		using is_transparent = std::true_type;
+		auto operator()(Edge const& x, Edge const& y) const -> bool {
+			return std::tie(get(x).from, get(x).to, get(x).weight)
+			       < std::tie(get(y).from, get(y).to, get(y).weight);
+		}
+		auto operator()(Edge const& x, src_key y) const -> bool {
+			return get(x).from < y.from;
+		}
+		auto operator()(src_key x, Edge const& y) const -> bool {
+			return x.from < get(y).from;
+		}
+	};
+
+	// the edges in random order, each from a node to 16 random others
+	auto const edges = [] {
+		auto random = std::mt19937_64{42};
+		auto result = std::vector<edge>{};
+		result.reserve(node_count * edges_per_node);
+		for (auto from = 0; from < node_count; ++from) {
+			for (auto i = 0; i < edges_per_node; ++i) {
+				auto const to = static_cast<int>(random() % node_count);
+				result.push_back(edge{nullptr, nullptr, from, to, static_cast<int>(random() % 4)});
+			}
+		}
+		std::shuffle(result.begin(), result.end(), random);
+		return result;
+	}();
+
+	template<typename Edge>
+	auto elements() -> std::vector<Edge> const& {
+		static auto const result = [] {
+			if constexpr (std::is_same_v<Edge, edge>) {
+				return edges;
+			}
+			else {
+				auto shared = std::vector<Edge>{};
+				shared.reserve(edges.size());
+				for (auto const& e : edges) {
+					shared.push_back(std::make_shared<edge>(e));
+				}
+				return shared;
+			}
+		}();
+		return result;
+	}
+
+	template<typename Set>
+	auto filled() -> Set const& {
+		using element = typename Set::value_type;
+		static auto const set = Set(elements<element>().begin(), elements<element>().end());
+		return set;
+	}
+
+	// calls f with a default constructed set of the kind benchmarked as range(0)
+	template<typename F>
+	auto with_set(benchmark::State& state, F f) -> void {
+		constexpr char const* names[] = {"std::set, inline edges",
+		                                 "absl::btree_set, inline edges",
+		                                 "std::set, shared edges",
+		                                 "absl::btree_set, shared edges"};
+		state.SetLabel(names[state.range(0)]);
+		using shared = std::shared_ptr<edge>;
+		switch (state.range(0)) {
+		case 0: f(std::set<edge, edge_less<edge>>{}); break;
+		case 1: f(absl::btree_set<edge, edge_less<edge>>{}); break;
+		case 2: f(std::set<shared, edge_less<shared>>{}); break;
+		default: f(absl::btree_set<shared, edge_less<shared>>{}); break;
+		}
+	}
+
+	auto lookup(benchmark::State& state) -> void {
+		with_set(state, [&]<typename Set>(Set const&) {
+			auto const& set = filled<Set>();
+			auto const& probes = elements<typename Set::value_type>();
+			auto next = std::size_t{0};
+			for (auto _ : state) {
+				for (auto i = 0; i < batch; ++i) {
+					benchmark::DoNotOptimize(set.find(probes[next++ % probes.size()]));
+				}
+			}
+		});
+		state.SetItemsProcessed(state.iterations() * batch);
+	}
+
+	auto range_scan(benchmark::State& state) -> void {
+		with_set(state, [&]<typename Set>(Set const&) {
+			auto const& set = filled<Set>();
+			auto next = std::size_t{0};
+			for (auto _ : state) {
+				auto sum = 0;
+				for (auto i = 0; i < batch; ++i) {
+					auto const from = edges[next++ % edges.size()].from;
+					auto [first, last] = set.equal_range(src_key{from});
+					for (; first != last; ++first) {
+						sum += get(*first).weight;
+					}
+				}
+				benchmark::DoNotOptimize(sum);
+			}
+		});
+		state.SetItemsProcessed(state.iterations() * batch);
+	}
+
+	auto insert(benchmark::State& state) -> void {
+		with_set(state, [&]<typename Set>(Set const&) {
+			auto const& values = elements<typename Set::value_type>();
+			for (auto _ : state) {
+				auto set = Set{};
+				for (auto const& e : values) {
+					set.insert(e);
+				}
+				benchmark::DoNotOptimize(set.size());
+				state.PauseTiming();
+				set.clear();
+				state.ResumeTiming();
+			}
+		});
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(edges.size()));
+	}
+
+	// ========================
+	// THE SAME, THROUGH GRAPH
+	// ------------------------
+
+	auto make_graph() -> gdwg::graph<int, int> {
+		auto values = std::vector<gdwg::graph<int, int>::value_type>{};
+		values.reserve(edges.size());
+		for (auto const& e : edges) {
+			values.push_back({e.from, e.to, e.weight});
+		}
+		return gdwg::graph<int, int>(values.begin(), values.end());
+	}
+
+	auto const& graph() {
+		static auto const g = make_graph();
+		return g;
+	}
+
+	auto graph_is_connected(benchmark::State& state) -> void {
+		auto const& g = graph();
+		auto next = std::size_t{0};
+		for (auto _ : state) {
+			for (auto i = 0; i < batch; ++i) {
+				auto const& e = edges[next++ % edges.size()];
+				benchmark::DoNotOptimize(g.is_connected(e.from, e.to));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * batch);
+	}
+
+	auto graph_connections(benchmark::State& state) -> void {
+		auto const& g = graph();
+		auto next = std::size_t{0};
+		for (auto _ : state) {
+			for (auto i = 0; i < batch; ++i) {
+				benchmark::DoNotOptimize(g.connections(edges[next++ % edges.size()].from).size());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * batch);
+	}
+
+	auto graph_insert_edge(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto g = gdwg::graph<int, int>{};
+			for (auto n = 0; n < node_count; ++n) {
+				g.insert_node(n);
+			}
+			for (auto const& e : edges) {
+				g.insert_edge(e.from, e.to, e.weight);
+			}
+			benchmark::DoNotOptimize(g.begin());
+			state.PauseTiming();
+			g.clear();
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(edges.size()));
+	}
+} // namespace
+
+BENCHMARK(lookup)->DenseRange(0, 3);
+BENCHMARK(range_scan)->DenseRange(0, 3);
+BENCHMARK(insert)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK(graph_is_connected);
+BENCHMARK(graph_connections);
+BENCHMARK(graph_insert_edge)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,54 @@
+#include "gdwg/algorithms/pagerank.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Twenty PageRank iterations over a frozen graph with 2^20 nodes and 2^24 edges, on a pool of
+// 1, 2, 4, ... threads. The frozen graph is built directly, since building a gdwg::graph of this
+// size would take longer than the benchmark itself. Sources are skewed towards low ids, so a few
+// nodes have far more out-edges than the rest.
+
+namespace {
+	auto make_graph(std::size_t nodes, std::size_t edges) -> gdwg::frozen_graph<int, double> {
+		auto names = std::vector<int>(nodes);
+		auto offsets = std::vector<std::size_t>(nodes + 1, 0);
+		auto edge_list = std::vector<std::pair<gdwg::node_id, gdwg::node_id>>(edges);
+		auto state = std::uint64_t{42};
+		for (auto& [from, to] : edge_list) {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			auto const r = static_cast<double>(state >> 11U) / static_cast<double>(1ULL << 53U);
+			from = static_cast<gdwg::node_id>(static_cast<double>(nodes) * r * r * r);
+			to = static_cast<gdwg::node_id>((state >> 7U) % nodes);
+			++offsets[from + 1];
+		}
+		for (auto i = std::size_t{0}; i < nodes; ++i) {
+			names[i] = static_cast<int>(i);
+			offsets[i + 1] += offsets[i];
+		}
+		auto next = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+		auto targets = std::vector<gdwg::node_id>(edges);
+		auto weights = std::vector<double>(edges);
+		for (auto const& [from, to] : edge_list) {
+			auto const slot = next[from]++;
+			targets[slot] = to;
+			weights[slot] = 1.0 + static_cast<double>(to % 3);
+		}
+		return {std::move(names), std::move(offsets), std::move(targets), std::move(weights)};
+	}
+
+	auto const g = make_graph(std::size_t{1} << 20U, std::size_t{1} << 24U);
+
+	auto pagerank(benchmark::State& state) -> void {
+		auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+		auto const opts = gdwg::algorithms::pagerank_options{.tolerance = 0.0, .max_iterations = 20};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::algorithms::pagerank(g, opts, pool).rank.data());
+		}
+		state.SetItemsProcessed(state.iterations() * 20 * static_cast<std::int64_t>(g.edge_count()));
+	}
+} // namespace
+
+BENCHMARK(pagerank)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
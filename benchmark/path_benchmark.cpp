@@ -0,0 +1,102 @@
+#include "gdwg/algorithms/shortest_paths.hpp"
+#include "gdwg/frozen_graph.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Point-to-point queries between random nodes of a 512 x 512 road-like grid (edges both ways
+// between neighbours, weights 1 to 4), answered one after another by the same path_search:
+// Dijkstra (A* with no estimate), bidirectional Dijkstra and A* with the Manhattan distance. The
+// time is for 1000 queries; p99_us is the 99th percentile latency of one query, in microseconds.
+
+namespace {
+	constexpr auto side = gdwg::node_id{512};
+	constexpr auto queries = std::size_t{1000};
+
+	auto make_grid() -> gdwg::frozen_graph<int, int> {
+		auto names = std::vector<int>(side * side);
+		auto offsets = std::vector<std::size_t>{0};
+		auto targets = std::vector<gdwg::node_id>{};
+		auto weights = std::vector<int>{};
+		auto state = std::uint64_t{42};
+		auto const weight = [&state] {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return 1 + static_cast<int>((state >> 33U) % 4);
+		};
+		for (auto v = gdwg::node_id{0}; v < side * side; ++v) {
+			names[v] = static_cast<int>(v);
+			// in increasing order of target, as frozen_graph keeps its rows
+			for (auto const to : {v >= side ? v - side : v,
+			                      v % side != 0 ? v - 1 : v,
+			                      v % side != side - 1 ? v + 1 : v,
+			                      v + side < side * side ? v + side : v})
+			{
+				if (to != v) {
+					targets.push_back(to);
+					weights.push_back(weight());
+				}
+			}
+			offsets.push_back(targets.size());
+		}
+		return {std::move(names), std::move(offsets), std::move(targets), std::move(weights)};
+	}
+
+	auto const g = make_grid();
+
+	auto manhattan(gdwg::node_id v, gdwg::node_id dst) -> int {
+		auto const dx = static_cast<int>(v % side) - static_cast<int>(dst % side);
+		auto const dy = static_cast<int>(v / side) - static_cast<int>(dst / side);
+		return std::abs(dx) + std::abs(dy);
+	}
+
+	template<typename Query>
+	auto run_queries(benchmark::State& state, Query query) -> void {
+		auto search = gdwg::algorithms::path_search<int, int>(g);
+		auto pairs = std::vector<std::pair<gdwg::node_id, gdwg::node_id>>(queries);
+		auto random = std::uint64_t{7};
+		for (auto& [src, dst] : pairs) {
+			random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+			src = static_cast<gdwg::node_id>((random >> 20U) % (side * side));
+			dst = static_cast<gdwg::node_id>((random >> 40U) % (side * side));
+		}
+		auto latency = std::vector<double>(queries);
+		for (auto _ : state) {
+			for (auto i = std::size_t{0}; i < queries; ++i) {
+				auto const start = std::chrono::steady_clock::now();
+				benchmark::DoNotOptimize(query(search, pairs[i].first, pairs[i].second).distance);
+				auto const time = std::chrono::steady_clock::now() - start;
+				latency[i] = std::chrono::duration<double, std::micro>(time).count();
+			}
+		}
+		auto const p99 = latency.begin() + static_cast<std::ptrdiff_t>(queries * 99 / 100);
+		std::nth_element(latency.begin(), p99, latency.end());
+		state.counters["p99_us"] = *p99;
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(queries));
+	}
+
+	auto dijkstra(benchmark::State& state) -> void {
+		run_queries(state, [](auto& search, gdwg::node_id src, gdwg::node_id dst) {
+			return search.a_star(src, dst, [](gdwg::node_id) { return 0; });
+		});
+	}
+
+	auto bidirectional(benchmark::State& state) -> void {
+		run_queries(state, [](auto& search, gdwg::node_id src, gdwg::node_id dst) {
+			return search.bidirectional_dijkstra(src, dst);
+		});
+	}
+
+	auto a_star(benchmark::State& state) -> void {
+		run_queries(state, [](auto& search, gdwg::node_id src, gdwg::node_id dst) {
+			return search.a_star(src, dst, [dst](gdwg::node_id v) { return manhattan(v, dst); });
+		});
+	}
+} // namespace
+
+BENCHMARK(dijkstra)->Unit(benchmark::kMillisecond);
+BENCHMARK(bidirectional)->Unit(benchmark::kMillisecond);
+BENCHMARK(a_star)->Unit(benchmark::kMillisecond);
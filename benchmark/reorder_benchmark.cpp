@@ -0,0 +1,129 @@
+#include "gdwg/algorithms/pagerank.hpp"
+#include "gdwg/algorithms/reorder.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Breadth-first search and PageRank over the same graph numbered four ways: as loaded, and
+// reordered by each node_ordering. The graph has 2^20 nodes and about 2^24 edges shaped like a
+// web crawl: most edges join nodes close together in a hidden order (pages of one site), the
+// rest go to a few heavily linked hubs. The ids it is loaded with are scattered over that order,
+// as they are when nodes are numbered by a hash or in the order a crawler found them.
+
+namespace {
+	constexpr auto as_loaded = std::int64_t{-1};
+
+	auto make_graph(std::size_t nodes, std::size_t edges_per_node)
+	   -> gdwg::frozen_graph<int, double> {
+		auto names = std::vector<int>(nodes);
+		auto offsets = std::vector<std::size_t>(nodes + 1, 0);
+		auto targets = std::vector<gdwg::node_id>{};
+		auto weights = std::vector<double>{};
+		targets.reserve(nodes * edges_per_node);
+		weights.reserve(nodes * edges_per_node);
+		auto state = std::uint64_t{42};
+		auto random = [&] {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return static_cast<double>(state >> 11U) / static_cast<double>(1ULL << 53U);
+		};
+		for (auto v = std::size_t{0}; v < nodes; ++v) {
+			names[v] = static_cast<int>(v);
+			for (auto e = std::size_t{0}; e < edges_per_node; ++e) {
+				auto const r = random();
+				auto const to =
+				   random() < 0.8 ? (v + static_cast<std::size_t>(r * r * 64.0) + 1) % nodes
+				                  : static_cast<std::size_t>(static_cast<double>(nodes) * r * r * r);
+				targets.push_back(static_cast<gdwg::node_id>(to));
+				weights.push_back(1.0 + static_cast<double>(to % 3));
+			}
+			offsets[v + 1] = targets.size();
+		}
+		auto const hidden =
+		   gdwg::frozen_graph<int, double>(names, offsets, std::move(targets), std::move(weights));
+		// multiplying by an odd number is a bijection modulo a power of two
+		auto scatter = std::vector<gdwg::node_id>(nodes);
+		for (auto i = std::size_t{0}; i < nodes; ++i) {
+			scatter[i] = static_cast<gdwg::node_id>((i * 2654435761U) % nodes);
+		}
+		return hidden.permute(scatter);
+	}
+
+	auto const loaded = make_graph(std::size_t{1} << 20U, 16);
+
+	auto numbered(std::int64_t strategy) -> gdwg::frozen_graph<int, double> const& {
+		static auto const graphs = [] {
+			auto result = std::vector<gdwg::frozen_graph<int, double>>{};
+			for (auto const s : {gdwg::algorithms::node_ordering::reverse_cuthill_mckee,
+			                     gdwg::algorithms::node_ordering::degree_descending,
+			                     gdwg::algorithms::node_ordering::breadth_first})
+			{
+				result.push_back(gdwg::algorithms::reorder(loaded, s));
+			}
+			return result;
+		}();
+		return strategy == as_loaded ? loaded : graphs[static_cast<std::size_t>(strategy)];
+	}
+
+	auto label(benchmark::State& state) -> void {
+		constexpr char const* names[] = {"reverse_cuthill_mckee",
+		                                 "degree_descending",
+		                                 "breadth_first"};
+		state.SetLabel(state.range(0) == as_loaded ? "as loaded" : names[state.range(0)]);
+	}
+
+	auto breadth_first_search(benchmark::State& state) -> void {
+		auto const& g = numbered(state.range(0));
+		auto const root = g.id(0);
+		constexpr auto unreached = std::numeric_limits<std::uint32_t>::max();
+		auto depth = std::vector<std::uint32_t>(g.size());
+		auto queue = std::vector<gdwg::node_id>{};
+		queue.reserve(g.size());
+		for (auto _ : state) {
+			std::fill(depth.begin(), depth.end(), unreached);
+			queue.clear();
+			depth[root] = 0;
+			queue.push_back(root);
+			for (auto next = std::size_t{0}; next != queue.size(); ++next) {
+				auto const v = queue[next];
+				for (auto const w : g.out_edges(v)) {
+					if (depth[w] == unreached) {
+						depth[w] = depth[v] + 1;
+						queue.push_back(w);
+					}
+				}
+			}
+			benchmark::DoNotOptimize(queue.data());
+		}
+		label(state);
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(g.edge_count()));
+	}
+
+	auto pagerank(benchmark::State& state) -> void {
+		auto const& g = numbered(state.range(0));
+		auto const opts = gdwg::algorithms::pagerank_options{.tolerance = 0.0, .max_iterations = 10};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::algorithms::pagerank(g, opts).rank.data());
+		}
+		label(state);
+		state.SetItemsProcessed(state.iterations() * 10 * static_cast<std::int64_t>(g.edge_count()));
+	}
+
+	// what reordering costs, to weigh against the speedups above
+	auto reorder(benchmark::State& state) -> void {
+		auto const strategy = static_cast<gdwg::algorithms::node_ordering>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::algorithms::reorder(loaded, strategy).targets().data());
+		}
+		label(state);
+	}
+} // namespace
+
+BENCHMARK(breadth_first_search)->DenseRange(-1, 2)->Unit(benchmark::kMillisecond);
+BENCHMARK(pagerank)->DenseRange(-1, 2)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(reorder)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,117 @@
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Full scans of 2^20 edges between 2^16 nodes, inserted in random order: through graph's
+// iterators, through for_each_edge (which prefetches ahead with shared edges), and over the
+// arrays of a frozen_graph, for a graph<int, int> (inline edges) and a graph<std::string, int>
+// (shared edges, whose nodes and edges are scattered over the heap). Each scan reads every
+// edge's src, dst and weight.
+
+namespace {
+	constexpr auto node_count = 1 << 16;
+	constexpr auto edges_per_node = 16;
+
+	auto const edges = [] {
+		auto random = std::mt19937_64{42};
+		auto result = std::vector<std::tuple<int, int, int>>{};
+		result.reserve(node_count * edges_per_node);
+		for (auto from = 0; from < node_count; ++from) {
+			for (auto i = 0; i < edges_per_node; ++i) {
+				auto const to = static_cast<int>(random() % node_count);
+				result.emplace_back(from, to, static_cast<int>(random() % 4));
+			}
+		}
+		std::shuffle(result.begin(), result.end(), random);
+		return result;
+	}();
+
+	auto name(int n) -> std::string {
+		auto digits = std::to_string(n);
+		return "node-" + std::string(6 - digits.size(), '0') + digits;
+	}
+
+	auto value(int n, int) -> int {
+		return n;
+	}
+	auto value(int n, std::string const&) -> std::string {
+		return name(n);
+	}
+
+	template<typename N>
+	auto const& graph() {
+		static auto const g = [] {
+			auto result = gdwg::graph<N, int>{};
+			for (auto const& [from, to, weight] : edges) {
+				result.insert_node(value(from, N{}));
+				result.insert_node(value(to, N{}));
+				result.insert_edge(value(from, N{}), value(to, N{}), weight);
+			}
+			return result;
+		}();
+		return g;
+	}
+
+	// what a scan reads of each edge
+	auto touch(int from, int to, int weight) -> std::int64_t {
+		return from + to + weight;
+	}
+	auto touch(std::string const& from, std::string const& to, int weight) -> std::int64_t {
+		return static_cast<std::int64_t>(from.back() + to.back() + weight);
+	}
+
+	template<typename N>
+	auto scan_iterators(benchmark::State& state) -> void {
+		auto const& g = graph<N>();
+		for (auto _ : state) {
+			auto sum = std::int64_t{0};
+			for (auto const& [from, to, weight] : g) {
+				sum += touch(from, to, weight);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(edges.size()));
+	}
+
+	template<typename N>
+	auto scan_for_each_edge(benchmark::State& state) -> void {
+		auto const& g = graph<N>();
+		for (auto _ : state) {
+			auto sum = std::int64_t{0};
+			g.for_each_edge(
+			   [&](N const& from, N const& to, int weight) { sum += touch(from, to, weight); });
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(edges.size()));
+	}
+
+	template<typename N>
+	auto scan_frozen(benchmark::State& state) -> void {
+		auto const frozen = graph<N>().freeze();
+		for (auto _ : state) {
+			auto sum = std::int64_t{0};
+			for (auto from = gdwg::node_id{0}; from < frozen.size(); ++from) {
+				auto const targets = frozen.out_edges(from);
+				auto const weights = frozen.out_weights(from);
+				for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+					sum += touch(frozen.node(from), frozen.node(targets[e]), weights[e]);
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(edges.size()));
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(scan_iterators, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(scan_for_each_edge, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(scan_frozen, int)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(scan_iterators, std::string)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(scan_for_each_edge, std::string)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(scan_frozen, std::string)->Unit(benchmark::kMillisecond);
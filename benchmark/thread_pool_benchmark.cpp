@@ -0,0 +1,84 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Compares the work-stealing pool against starting one std::thread per core with a fixed, equal
+// slice of the edges each. The per-edge work is a hash loop whose length depends on the edge, so
+// the "skewed" runs put most of the cost in a few slices, which is where stealing pays off.
+
+namespace {
+	using graph = gdwg::graph<int, int>;
+
+	auto make_graph(int nodes, int edges) -> graph {
+		auto v = std::vector<graph::value_type>{};
+		v.reserve(static_cast<std::size_t>(edges));
+		auto state = std::uint64_t{42};
+		for (auto i = 0; i < edges; ++i) {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			auto const from = static_cast<int>((state >> 33U) % static_cast<std::uint64_t>(nodes));
+			auto const to = static_cast<int>((state >> 17U) % static_cast<std::uint64_t>(nodes));
+			v.push_back({from, to, i});
+		}
+		return graph(v.begin(), v.end());
+	}
+
+	auto edge_work(graph::value_type const& e, bool skewed) -> std::uint64_t {
+		auto const rounds = skewed and e.from < 1024 ? 512 : 16;
+		auto h = static_cast<std::uint64_t>(e.weight);
+		for (auto i = 0; i < rounds; ++i) {
+			h ^= h >> 31U;
+			h *= 0x9E3779B97F4A7C15ULL;
+		}
+		return h;
+	}
+
+	auto const g = make_graph(1 << 14, 1 << 20);
+
+	auto work_stealing(benchmark::State& state) -> void {
+		auto const skewed = state.range(0) != 0;
+		auto& pool = gdwg::thread_pool::shared();
+		for (auto _ : state) {
+			auto sum = std::atomic<std::uint64_t>{0};
+			gdwg::parallel_for_each_edge(pool, g, [&](graph::value_type const& e) {
+				sum.fetch_add(edge_work(e, skewed), std::memory_order_relaxed);
+			});
+			benchmark::DoNotOptimize(sum.load());
+		}
+		state.SetItemsProcessed(state.iterations() * (1 << 20));
+	}
+
+	auto naive_fan_out(benchmark::State& state) -> void {
+		auto const skewed = state.range(0) != 0;
+		auto const threads = std::max(1U, std::thread::hardware_concurrency());
+		for (auto _ : state) {
+			auto edges = std::vector<graph::value_type>{};
+			for (auto const& [from, to, weight] : g) {
+				edges.push_back({from, to, weight});
+			}
+			auto sum = std::atomic<std::uint64_t>{0};
+			auto workers = std::vector<std::thread>{};
+			for (auto t = 0U; t < threads; ++t) {
+				workers.emplace_back([&, t] {
+					auto const first = edges.size() * t / threads;
+					auto const last = edges.size() * (t + 1) / threads;
+					for (auto i = first; i != last; ++i) {
+						sum.fetch_add(edge_work(edges[i], skewed), std::memory_order_relaxed);
+					}
+				});
+			}
+			for (auto& w : workers) {
+				w.join();
+			}
+			benchmark::DoNotOptimize(sum.load());
+		}
+		state.SetItemsProcessed(state.iterations() * (1 << 20));
+	}
+} // namespace
+
+BENCHMARK(work_stealing)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(naive_fan_out)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
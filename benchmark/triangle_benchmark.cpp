@@ -0,0 +1,72 @@
+#include "gdwg/algorithms/triangles.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Triangle counts and clustering coefficients of a frozen graph with 2^20 nodes and 2^23 edges,
+// on a pool of 1, 2, 4, ... threads. Both ends of each edge are skewed towards low ids, so the
+// low ids form a dense core full of triangles and a few nodes have very high degree, as in a
+// social or transaction graph.
+
+namespace {
+	auto make_graph(std::size_t nodes, std::size_t edges) -> gdwg::frozen_graph<int, int> {
+		auto names = std::vector<int>(nodes);
+		auto offsets = std::vector<std::size_t>(nodes + 1, 0);
+		auto edge_list = std::vector<std::pair<gdwg::node_id, gdwg::node_id>>(edges);
+		auto state = std::uint64_t{42};
+		auto skewed = [&state, nodes] {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			auto const r = static_cast<double>(state >> 11U) / static_cast<double>(1ULL << 53U);
+			return static_cast<gdwg::node_id>(static_cast<double>(nodes) * r * r * r);
+		};
+		for (auto& [from, to] : edge_list) {
+			from = skewed();
+			to = skewed();
+		}
+		std::sort(edge_list.begin(), edge_list.end());
+		auto targets = std::vector<gdwg::node_id>(edges);
+		for (auto i = std::size_t{0}; i < edges; ++i) {
+			++offsets[edge_list[i].first + 1];
+			targets[i] = edge_list[i].second;
+		}
+		for (auto i = std::size_t{0}; i < nodes; ++i) {
+			names[i] = static_cast<int>(i);
+			offsets[i + 1] += offsets[i];
+		}
+		auto weights = std::vector<int>(edges, 1);
+		return {std::move(names), std::move(offsets), std::move(targets), std::move(weights)};
+	}
+
+	auto const g = make_graph(std::size_t{1} << 20U, std::size_t{1} << 23U);
+
+	auto triangle_count(benchmark::State& state) -> void {
+		auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::algorithms::triangle_count(g, pool));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(g.edge_count()));
+	}
+
+	auto clustering_coefficients(benchmark::State& state) -> void {
+		auto pool = gdwg::thread_pool(static_cast<std::size_t>(state.range(0)));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::algorithms::clustering_coefficients(g, pool).data());
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(g.edge_count()));
+	}
+} // namespace
+
+BENCHMARK(triangle_count)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime()
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(clustering_coefficients)
+   ->RangeMultiplier(2)
+   ->Range(1, 16)
+   ->UseRealTime()
+   ->Unit(benchmark::kMillisecond);
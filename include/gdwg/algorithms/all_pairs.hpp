@@ -0,0 +1,296 @@
+#ifndef GDWG_ALGORITHMS_ALL_PAIRS_HPP
+#define GDWG_ALGORITHMS_ALL_PAIRS_HPP
+
+#include "gdwg/algorithms/shortest_paths.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	// the length of a shortest path between every pair of nodes, row-major: distance[from * size +
+	// to], in frozen_graph (nodes()) order. Pairs with no path hold unreachable.
+	template<typename E>
+	struct distance_matrix {
+		// infinity where E has one; otherwise half of E's maximum, so that adding two distances
+		// never overflows. Real distances must stay below it.
+		static constexpr E unreachable = std::numeric_limits<E>::has_infinity
+		                                    ? std::numeric_limits<E>::infinity()
+		                                    : std::numeric_limits<E>::max() / 2;
+
+		std::size_t size = 0;
+		std::vector<E> distance{};
+
+		[[nodiscard]] auto operator()(node_id from, node_id to) const noexcept -> E const& {
+			return distance[from * size + to];
+		}
+		[[nodiscard]] auto reachable(node_id from, node_id to) const noexcept -> bool {
+			return (*this)(from, to) != unreachable;
+		}
+		[[nodiscard]] auto operator==(distance_matrix const& other) const -> bool = default;
+	};
+
+	enum class apsp_algorithm {
+		automatic, // Johnson when the average node has fewer than size / johnson_degree_ratio edges
+		floyd_warshall,
+		johnson,
+	};
+
+	// Johnson's algorithm is picked for graphs with fewer than size / johnson_degree_ratio distinct
+	// (src, dst) pairs per node, where V runs of Dijkstra beat one O(V^3) pass of Floyd-Warshall
+	inline constexpr auto johnson_degree_ratio = std::size_t{16};
+
+	namespace detail {
+		// Floyd-Warshall works on square tiles of this many rows and columns; one tile of
+		// four-byte weights is 16 KiB, so the three a step touches fit in the L1 or L2 cache
+		inline constexpr auto apsp_block = std::size_t{64};
+
+		// number of distinct (src, dst) pairs, self loops aside
+		template<typename N, typename E>
+		[[nodiscard]] auto distinct_pairs(frozen_graph<N, E> const& g) -> std::size_t {
+			auto pairs = std::size_t{0};
+			for (auto from = node_id{0}; from < g.size(); ++from) {
+				auto const row = g.out_edges(from);
+				for (auto i = std::size_t{0}; i < row.size(); ++i) {
+					if (row[i] != from and (i == 0 or row[i - 1] != row[i])) {
+						++pairs;
+					}
+				}
+			}
+			return pairs;
+		}
+
+		// Johnson's reweighting: potentials h with w(u, v) + h(u) - h(v) >= 0 for every edge,
+		// found by Bellman-Ford from a virtual node with a zero-weight edge to every node. Shortest
+		// paths are the same under the new weights, and no weight is negative any more. Throws if
+		// there is a cycle of negative weight, where shortest paths aren't defined.
+		template<typename N, typename E>
+		[[nodiscard]] auto potentials(frozen_graph<N, E> const& g) -> std::vector<E> {
+			auto h = std::vector<E>(g.size(), E{});
+			auto const& offsets = g.offsets();
+			auto const& targets = g.targets();
+			auto const& weights = g.weights();
+			for (auto round = std::size_t{0}; round <= g.size(); ++round) {
+				auto changed = false;
+				for (auto from = node_id{0}; from < g.size(); ++from) {
+					for (auto e = offsets[from]; e != offsets[from + 1]; ++e) {
+						auto const through = static_cast<E>(h[from] + weights[e]);
+						if (through < h[targets[e]]) {
+							h[targets[e]] = through;
+							changed = true;
+						}
+					}
+				}
+				if (!changed) {
+					return h;
+				}
+			}
+			throw std::invalid_argument("Cannot call gdwg::algorithms::all_pairs_shortest_paths on a "
+			                            "graph with a negative cycle");
+		}
+
+		// One Floyd-Warshall step over a tile: c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for each
+		// k of the tile in turn. c may be a or b (or both), as in the first two phases: row and
+		// column k don't change in step k, so updating in place is still exact. The inner loop is
+		// a plain add and min over contiguous rows, which the compiler vectorizes.
+		template<typename E>
+		auto relax_tile(E* c, E const* a, E const* b, std::size_t stride) -> void {
+			constexpr auto unreachable = distance_matrix<E>::unreachable;
+			for (auto k = std::size_t{0}; k < apsp_block; ++k) {
+				auto const* bk = b + k * stride;
+				for (auto i = std::size_t{0}; i < apsp_block; ++i) {
+					auto const aik = a[i * stride + k];
+					if (aik == unreachable) {
+						continue;
+					}
+					auto* ci = c + i * stride;
+					for (auto j = std::size_t{0}; j < apsp_block; ++j) {
+						auto const through = static_cast<E>(aik + bk[j]);
+						ci[j] = through < ci[j] ? through : ci[j];
+					}
+				}
+			}
+		}
+
+		// Blocked Floyd-Warshall on a matrix padded to whole tiles. Each round k takes the tile
+		// on the diagonal, then the rest of its tile row and column (which only need the diagonal
+		// tile), then every other tile (which only needs the row and column); the tiles of the last
+		// two phases are independent, so each phase is split over the pool.
+		template<typename E>
+		auto floyd_warshall(std::vector<E>& d, std::size_t stride, thread_pool& pool) -> void {
+			auto const tiles = stride / apsp_block;
+			auto const tile = [&](std::size_t i, std::size_t j) {
+				return d.data() + (i * stride + j) * apsp_block;
+			};
+			for (auto k = std::size_t{0}; k < tiles; ++k) {
+				relax_tile(tile(k, k), tile(k, k), tile(k, k), stride);
+				pool.parallel_for(
+				   2 * tiles,
+				   [&](std::size_t t, std::size_t last) {
+					   for (; t != last; ++t) {
+						   auto const other = t % tiles;
+						   if (other == k) {
+							   continue;
+						   }
+						   if (t < tiles) {
+							   relax_tile(tile(k, other), tile(k, k), tile(k, other), stride);
+						   }
+						   else {
+							   relax_tile(tile(other, k), tile(other, k), tile(k, k), stride);
+						   }
+					   }
+				   },
+				   1);
+				pool.parallel_for(
+				   tiles * tiles,
+				   [&](std::size_t t, std::size_t last) {
+					   for (; t != last; ++t) {
+						   auto const i = t / tiles;
+						   auto const j = t % tiles;
+						   if (i != k and j != k) {
+							   relax_tile(tile(i, j), tile(i, k), tile(k, j), stride);
+						   }
+					   }
+				   },
+				   1);
+			}
+		}
+
+		// Dijkstra from every node, each worker reusing one search_frontier for all of its sources
+		template<typename N, typename E>
+		auto johnson(frozen_graph<N, E> const& g,
+		             std::vector<E> const& weights,
+		             distance_matrix<E>& result,
+		             thread_pool& pool) -> void {
+			auto const n = g.size();
+			auto const& offsets = g.offsets();
+			auto const& targets = g.targets();
+			pool.parallel_for(n, [&](std::size_t src, std::size_t last) {
+				auto frontier = search_frontier<E>(n);
+				auto generation = std::uint32_t{0};
+				for (; src != last; ++src) {
+					auto* row = result.distance.data() + src * n;
+					frontier.reset(++generation);
+					frontier.relax(static_cast<node_id>(src), E{}, static_cast<node_id>(src), E{});
+					while (true) {
+						frontier.skip_stale();
+						if (frontier.empty()) {
+							break;
+						}
+						auto const v = frontier.settle_top();
+						auto const dv = frontier.distance(v);
+						row[v] = dv;
+						for (auto e = offsets[v]; e != offsets[v + 1]; ++e) {
+							auto const d = static_cast<E>(dv + weights[e]);
+							frontier.relax(targets[e], d, v, d);
+						}
+					}
+				}
+			});
+		}
+	} // namespace detail
+
+	// ===========================
+	// ALL-PAIRS SHORTEST PATHS
+	// ---------------------------
+
+	// The distance from every node to every other, as a dense V x V matrix, with parallel edges
+	// counted at their lightest weight. E must be arithmetic. Negative weights are allowed as long
+	// as no cycle has negative total weight (that throws std::invalid_argument): if there are any,
+	// the weights are first made non-negative with Johnson's reweighting and the distances
+	// restored at the end, whichever algorithm runs.
+	//   * Floyd-Warshall: O(V^3), blocked into tiles that stay in cache, with each phase's tiles
+	//     spread over the pool and a vectorized inner loop. Best for dense graphs.
+	//   * Johnson: Dijkstra from every node in parallel, O(V (E + V) log V). Best for sparse
+	//     graphs, where it does far less work than Floyd-Warshall.
+	// The matrix takes V^2 elements, which is the limit on the size of graph this suits.
+	template<typename N, typename E>
+	[[nodiscard]] auto all_pairs_shortest_paths(frozen_graph<N, E> const& g,
+	                                            apsp_algorithm algorithm = apsp_algorithm::automatic,
+	                                            thread_pool& pool = thread_pool::shared())
+	   -> distance_matrix<E> {
+		static_assert(std::is_arithmetic_v<E>, "all_pairs_shortest_paths needs arithmetic weights");
+		constexpr auto unreachable = distance_matrix<E>::unreachable;
+		auto const n = g.size();
+		auto const& offsets = g.offsets();
+		auto const& targets = g.targets();
+		auto result = distance_matrix<E>{n, std::vector<E>(n * n, unreachable)};
+		if (n == 0) {
+			return result;
+		}
+
+		auto const negative = [](E const& w) { return w < E{}; };
+		auto const reweight = std::any_of(g.weights().begin(), g.weights().end(), negative);
+		auto h = std::vector<E>{};
+		auto weights = g.weights();
+		if (reweight) {
+			h = detail::potentials(g);
+			for (auto from = node_id{0}; from < n; ++from) {
+				for (auto e = offsets[from]; e != offsets[from + 1]; ++e) {
+					// rounding can leave a float a hair below zero
+					auto const w = static_cast<E>(weights[e] + h[from] - h[targets[e]]);
+					weights[e] = std::max(w, E{});
+				}
+			}
+		}
+
+		if (algorithm == apsp_algorithm::automatic) {
+			algorithm = detail::distinct_pairs(g) * johnson_degree_ratio < n * n
+			               ? apsp_algorithm::johnson
+			               : apsp_algorithm::floyd_warshall;
+		}
+		if (algorithm == apsp_algorithm::johnson) {
+			detail::johnson(g, weights, result, pool);
+		}
+		else {
+			auto const stride = (n + detail::apsp_block - 1) / detail::apsp_block * detail::apsp_block;
+			auto d = std::vector<E>(stride * stride, unreachable);
+			for (auto from = node_id{0}; from < n; ++from) {
+				d[from * stride + from] = E{};
+				for (auto e = offsets[from]; e != offsets[from + 1]; ++e) {
+					auto& cell = d[from * stride + targets[e]];
+					cell = std::min(cell, weights[e]);
+				}
+			}
+			detail::floyd_warshall(d, stride, pool);
+			for (auto from = std::size_t{0}; from < n; ++from) {
+				std::copy_n(d.begin() + static_cast<std::ptrdiff_t>(from * stride),
+				            n,
+				            result.distance.begin() + static_cast<std::ptrdiff_t>(from * n));
+			}
+		}
+
+		if (reweight) {
+			pool.parallel_for(n, [&](std::size_t from, std::size_t last) {
+				for (; from != last; ++from) {
+					for (auto to = std::size_t{0}; to < n; ++to) {
+						auto& cell = result.distance[from * n + to];
+						if (cell != unreachable) {
+							cell = static_cast<E>(cell - h[from] + h[to]);
+						}
+					}
+				}
+			});
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto all_pairs_shortest_paths(graph<N, E> const& g,
+	                                            apsp_algorithm algorithm = apsp_algorithm::automatic,
+	                                            thread_pool& pool = thread_pool::shared())
+	   -> distance_matrix<E> {
+		return all_pairs_shortest_paths(g.freeze(), algorithm, pool);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_ALL_PAIRS_HPP
@@ -0,0 +1,173 @@
+#ifndef GDWG_ALGORITHMS_COMPONENTS_HPP
+#define GDWG_ALGORITHMS_COMPONENTS_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	// a labelling of the nodes: label[i] is the component of node i (in frozen_graph / nodes()
+	// order), and the labels are dense, 0..count-1
+	struct components {
+		std::size_t count = 0;
+		std::vector<node_id> label{};
+	};
+
+	// ==============================
+	// STRONGLY CONNECTED COMPONENTS
+	// ------------------------------
+
+	// Tarjan's algorithm with an explicit call stack, so a long path cannot overflow the machine
+	// stack. O(V + E). Components are numbered in the order they are completed, which is a reverse
+	// topological order of the condensation: every edge between two components goes from the
+	// higher label to the lower one.
+	template<typename N, typename E>
+	[[nodiscard]] auto scc(frozen_graph<N, E> const& g) -> components {
+		constexpr auto unvisited = std::numeric_limits<node_id>::max();
+		auto const n = g.size();
+		auto const& offsets = g.offsets();
+		auto const& targets = g.targets();
+
+		auto result = components{0, std::vector<node_id>(n)};
+		auto index = std::vector<node_id>(n, unvisited);
+		auto low = std::vector<node_id>(n);
+		auto on_stack = std::vector<bool>(n, false);
+		auto stack = std::vector<node_id>{};
+		auto call = std::vector<std::pair<node_id, std::size_t>>{}; // node, next edge to follow
+		auto next_index = node_id{0};
+
+		auto visit = [&](node_id v) {
+			index[v] = low[v] = next_index++;
+			stack.push_back(v);
+			on_stack[v] = true;
+			call.emplace_back(v, offsets[v]);
+		};
+
+		for (auto root = node_id{0}; root < n; ++root) {
+			if (index[root] != unvisited) {
+				continue;
+			}
+			visit(root);
+			while (!call.empty()) {
+				auto const v = call.back().first;
+				if (call.back().second != offsets[v + 1]) {
+					auto const w = targets[call.back().second++];
+					if (index[w] == unvisited) {
+						visit(w);
+					}
+					else if (on_stack[w]) {
+						low[v] = std::min(low[v], index[w]);
+					}
+					continue;
+				}
+				// all of v's edges are done
+				if (low[v] == index[v]) {
+					auto w = v;
+					do {
+						w = stack.back();
+						stack.pop_back();
+						on_stack[w] = false;
+						result.label[w] = static_cast<node_id>(result.count);
+					} while (w != v);
+					++result.count;
+				}
+				call.pop_back();
+				if (!call.empty()) {
+					auto const parent = call.back().first;
+					low[parent] = std::min(low[parent], low[v]);
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto scc(graph<N, E> const& g) -> components {
+		return scc(g.freeze());
+	}
+
+	// ============================
+	// WEAKLY CONNECTED COMPONENTS
+	// ----------------------------
+
+	// Edges are treated as undirected and merged into a lock-free union-find from every worker of
+	// the pool at once. A union always links the larger root under the smaller one, so each root
+	// ends up being the smallest node of its component, and components are numbered in the order
+	// of their smallest node. O(V + E) work (near enough: finds use path halving).
+	template<typename N, typename E>
+	[[nodiscard]] auto wcc(frozen_graph<N, E> const& g, thread_pool& pool = thread_pool::shared())
+	   -> components {
+		auto const n = g.size();
+		auto parent = std::vector<std::atomic<node_id>>(n);
+		pool.parallel_for(n, [&](std::size_t first, std::size_t last) {
+			for (; first != last; ++first) {
+				parent[first].store(static_cast<node_id>(first), std::memory_order_relaxed);
+			}
+		});
+
+		auto find = [&](node_id x) {
+			while (true) {
+				auto p = parent[x].load();
+				if (p == x) {
+					return x;
+				}
+				auto const grandparent = parent[p].load();
+				if (p == grandparent) {
+					return p;
+				}
+				parent[x].compare_exchange_weak(p, grandparent); // path halving, may lose a race
+				x = grandparent;
+			}
+		};
+		auto unite = [&](node_id a, node_id b) {
+			while (true) {
+				a = find(a);
+				b = find(b);
+				if (a == b) {
+					return;
+				}
+				if (a < b) {
+					std::swap(a, b);
+				}
+				auto expected = a;
+				if (parent[a].compare_exchange_strong(expected, b)) {
+					return;
+				}
+			}
+		};
+
+		pool.parallel_for(n, [&](std::size_t first, std::size_t last) {
+			for (; first != last; ++first) {
+				auto const from = static_cast<node_id>(first);
+				for (auto const to : g.out_edges(from)) {
+					unite(from, to);
+				}
+			}
+		});
+
+		auto result = components{0, std::vector<node_id>(n)};
+		for (auto i = node_id{0}; i < n; ++i) {
+			auto const root = find(i);
+			// roots are the smallest node of their component, so they are labelled first
+			result.label[i] = root == i ? static_cast<node_id>(result.count++) : result.label[root];
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto wcc(graph<N, E> const& g, thread_pool& pool = thread_pool::shared())
+	   -> components {
+		return wcc(g.freeze(), pool);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_COMPONENTS_HPP
@@ -0,0 +1,185 @@
+#ifndef GDWG_ALGORITHMS_PAGERANK_HPP
+#define GDWG_ALGORITHMS_PAGERANK_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	struct pagerank_options {
+		double damping = 0.85;
+		// stop once the ranks change by less than this in total (L1 norm) over one iteration
+		double tolerance = 1e-9;
+		std::size_t max_iterations = 100;
+		// use the edge weights as transition weights; only has an effect when E is arithmetic
+		bool weighted = true;
+	};
+
+	// rank[i] is the score of node i (in frozen_graph / nodes() order); the ranks sum to 1
+	struct pagerank_result {
+		std::vector<double> rank{};
+		std::size_t iterations = 0;
+		bool converged = false;
+	};
+
+	namespace detail {
+		// [bounds[b], bounds[b + 1]) are the nodes of block b, chosen so that every block has about
+		// the same number of edges rather than the same number of nodes
+		[[nodiscard]] inline auto edge_balanced_blocks(std::vector<std::size_t> const& offsets,
+		                                               std::size_t blocks)
+		   -> std::vector<std::size_t> {
+			auto const n = offsets.size() - 1;
+			auto const edges = offsets.back();
+			auto bounds = std::vector<std::size_t>(blocks + 1, n);
+			bounds.front() = 0;
+			for (auto b = std::size_t{1}; b < blocks; ++b) {
+				auto const it =
+				   std::lower_bound(offsets.begin(), offsets.end() - 1, edges * b / blocks);
+				bounds[b] = static_cast<std::size_t>(it - offsets.begin());
+			}
+			return bounds;
+		}
+
+		// sum of f(first, last) over the blocks, run on the pool. The partial sums are added in
+		// block order so the result does not depend on which worker ran which block.
+		template<typename F>
+		[[nodiscard]] auto sum_blocks(thread_pool& pool, std::vector<std::size_t> const& bounds, F f)
+		   -> double {
+			auto const blocks = bounds.size() - 1;
+			auto partial = std::vector<double>(blocks, 0.0);
+			pool.parallel_for(
+			   blocks,
+			   [&](std::size_t block, std::size_t last) {
+				   for (; block != last; ++block) {
+					   partial[block] = f(bounds[block], bounds[block + 1]);
+				   }
+			   },
+			   1);
+			return std::accumulate(partial.begin(), partial.end(), 0.0);
+		}
+	} // namespace detail
+
+	// ==========
+	// PAGERANK
+	// ----------
+
+	// Power iteration, pull based: each iteration walks the transpose, so every node sums the
+	// contributions of its in-edges into its own rank and no two threads ever write the same
+	// element. The mass of nodes without out-edges (or with zero total out-weight) is spread over
+	// every node. Work is split into blocks of about equal edge count, since real graphs have a
+	// few nodes with far more edges than the rest.
+	template<typename N, typename E>
+	[[nodiscard]] auto pagerank(frozen_graph<N, E> const& g,
+	                            pagerank_options const& opts = {},
+	                            thread_pool& pool = thread_pool::shared()) -> pagerank_result {
+		if (!(opts.damping >= 0.0 and opts.damping <= 1.0)) {
+			throw std::invalid_argument("Cannot call gdwg::algorithms::pagerank with a damping factor "
+			                            "outside [0, 1]");
+		}
+		auto const n = g.size();
+		if (n == 0) {
+			return {{}, 0, true};
+		}
+		auto const in = g.transpose();
+		auto const& in_offsets = in.offsets();
+		auto const& sources = in.targets();
+		auto const& in_weights = in.weights();
+		auto const weighted = std::is_arithmetic_v<E> and opts.weighted;
+		auto const negative = [](E const& w) { return w < E{}; };
+		if (weighted and std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+			throw std::invalid_argument("Cannot call gdwg::algorithms::pagerank with a negative edge "
+			                            "weight");
+		}
+
+		auto const blocks = std::max(std::size_t{1},
+		                             std::min(g.edge_count() / gdwg::detail::parallel_threshold,
+		                                      8 * pool.size()));
+		auto const node_bounds = detail::edge_balanced_blocks(g.offsets(), blocks);
+		auto const pull_bounds = detail::edge_balanced_blocks(in_offsets, blocks);
+
+		// total weight leaving each node; contributions are divided by it
+		auto out_weight = std::vector<double>(n);
+		pool.parallel_for(n, [&](std::size_t v, std::size_t last) {
+			for (; v != last; ++v) {
+				auto const from = static_cast<node_id>(v);
+				auto total = static_cast<double>(g.out_degree(from));
+				if constexpr (std::is_arithmetic_v<E>) {
+					if (weighted) {
+						total = 0.0;
+						for (auto const w : g.out_weights(from)) {
+							total += static_cast<double>(w);
+						}
+					}
+				}
+				out_weight[v] = total;
+			}
+		});
+
+		auto result = pagerank_result{std::vector<double>(n, 1.0 / static_cast<double>(n))};
+		auto next = std::vector<double>(n);
+		auto contribution = std::vector<double>(n);
+		auto const d = opts.damping;
+		while (result.iterations < opts.max_iterations) {
+			// rank held by dangling nodes, which is shared out evenly instead of along edges
+			auto const push = [&](std::size_t v, std::size_t last) {
+				auto mass = 0.0;
+				for (; v != last; ++v) {
+					if (out_weight[v] > 0.0) {
+						contribution[v] = result.rank[v] / out_weight[v];
+					}
+					else {
+						contribution[v] = 0.0;
+						mass += result.rank[v];
+					}
+				}
+				return mass;
+			};
+			auto const dangling = detail::sum_blocks(pool, node_bounds, push);
+			auto const base = ((1.0 - d) + d * dangling) / static_cast<double>(n);
+			auto const pull = [&](std::size_t v, std::size_t last) {
+				auto delta = 0.0;
+				for (; v != last; ++v) {
+					auto sum = 0.0;
+					for (auto e = in_offsets[v]; e != in_offsets[v + 1]; ++e) {
+						auto c = contribution[sources[e]];
+						if constexpr (std::is_arithmetic_v<E>) {
+							c *= weighted ? static_cast<double>(in_weights[e]) : 1.0;
+						}
+						sum += c;
+					}
+					next[v] = base + d * sum;
+					delta += std::abs(next[v] - result.rank[v]);
+				}
+				return delta;
+			};
+			auto const change = detail::sum_blocks(pool, pull_bounds, pull);
+			result.rank.swap(next);
+			++result.iterations;
+			if (change < opts.tolerance) {
+				result.converged = true;
+				break;
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto pagerank(graph<N, E> const& g,
+	                            pagerank_options const& opts = {},
+	                            thread_pool& pool = thread_pool::shared()) -> pagerank_result {
+		return pagerank(g.freeze(), opts, pool);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_PAGERANK_HPP
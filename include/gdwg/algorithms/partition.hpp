@@ -0,0 +1,425 @@
+#ifndef GDWG_ALGORITHMS_PARTITION_HPP
+#define GDWG_ALGORITHMS_PARTITION_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	enum class partition_method {
+		fennel, // Tsourakakis et al., "FENNEL: streaming graph partitioning for massive scale graphs"
+		ldg, // Stanton and Kliot, "Streaming graph partitioning for large distributed graphs"
+	};
+
+	struct partition_options {
+		partition_method method = partition_method::fennel;
+		// parts are kept to imbalance * V / k nodes (rounded down, but at least ceil(V / k)). A
+		// coarse node that fits in no part goes over, which is rare and only by a little.
+		double imbalance = 1.1;
+		// the exponent of Fennel's size penalty
+		double gamma = 1.5;
+		// contract clusters found by label propagation before streaming, and refine on the way
+		// back out; without it the nodes are streamed one by one, in node order
+		bool coarsen = true;
+		// sweeps of greedy moves over every node, at each level
+		std::size_t refinement_passes = 4;
+	};
+
+	// part[i] is the part of node i (in frozen_graph / nodes() order), 0..parts-1. edge_cut is the
+	// number of edges (counting parallel edges) whose ends are in different parts.
+	struct partitioning {
+		std::size_t parts = 0;
+		std::vector<std::uint32_t> part{};
+		std::size_t edge_cut = 0;
+	};
+
+	// one part as a graph of its own, for the process that holds it. Every edge of the whole
+	// graph belongs to exactly one part: the part of its src.
+	template<typename N, typename E>
+	struct graph_part {
+		// the owned nodes, every edge from them, and the ghost nodes those edges lead to
+		graph<N, E> g{};
+		// the nodes of this part, sorted
+		std::vector<N> owned{};
+		// the owned nodes with an edge to or from another part, sorted
+		std::vector<N> boundary{};
+		// nodes of other parts that owned nodes have edges to, sorted, with the part that owns each
+		std::vector<std::pair<N, std::size_t>> ghosts{};
+	};
+
+	namespace detail {
+		// an undirected graph with weighted nodes and edges, in CSR form with both directions of
+		// each edge stored; the level the partitioner works on
+		struct weighted_graph {
+			std::vector<std::size_t> weight{};
+			std::vector<std::size_t> offsets{0};
+			std::vector<node_id> targets{};
+			std::vector<std::size_t> edge_weight{};
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return weight.size();
+			}
+		};
+
+		// the weighted graph with the given node weights and (from, to, weight) edges, which must
+		// hold both directions. Self loops are dropped and parallel edges merged.
+		[[nodiscard]] inline auto
+		make_weighted_graph(std::vector<std::size_t> weight,
+		                    std::vector<std::tuple<node_id, node_id, std::size_t>> edges)
+		   -> weighted_graph {
+			std::sort(edges.begin(), edges.end());
+			auto result = weighted_graph{std::move(weight), {}, {}, {}};
+			result.offsets.assign(result.size() + 1, 0);
+			for (auto const& [from, to, w] : edges) {
+				if (from == to) {
+					continue;
+				}
+				if (!result.targets.empty() and result.offsets[from + 1] != 0
+				    and result.targets.back() == to)
+				{
+					result.edge_weight.back() += w;
+					continue;
+				}
+				result.targets.push_back(to);
+				result.edge_weight.push_back(w);
+				++result.offsets[from + 1];
+			}
+			for (auto i = std::size_t{0}; i < result.size(); ++i) {
+				result.offsets[i + 1] += result.offsets[i];
+			}
+			return result;
+		}
+
+		// totals the weight of v's edges into each group of a labelling. Reused from node to node:
+		// only the groups touched by the last add() are cleared again.
+		class connection_count {
+		public:
+			explicit connection_count(std::size_t groups)
+			: weight_(groups, 0) {}
+
+			auto add(weighted_graph const& g, node_id v, std::vector<std::uint32_t> const& label)
+			   -> void {
+				for (auto const p : touched_) {
+					weight_[p] = 0;
+				}
+				touched_.clear();
+				for (auto e = g.offsets[v]; e != g.offsets[v + 1]; ++e) {
+					auto const p = label[g.targets[e]];
+					if (p == unlabelled) {
+						continue;
+					}
+					if (weight_[p] == 0) {
+						touched_.push_back(p);
+					}
+					weight_[p] += g.edge_weight[e];
+				}
+			}
+
+			[[nodiscard]] auto operator[](std::size_t p) const -> std::size_t {
+				return weight_[p];
+			}
+			[[nodiscard]] auto touched() const -> std::vector<std::uint32_t> const& {
+				return touched_;
+			}
+
+			static constexpr auto unlabelled = std::numeric_limits<std::uint32_t>::max();
+
+		private:
+			std::vector<std::size_t> weight_;
+			std::vector<std::uint32_t> touched_{};
+		};
+
+		// size-constrained label propagation: each node in turn joins the neighbouring cluster it
+		// has the heaviest edges into, as long as the cluster stays within limit. Returns the
+		// clusters numbered densely, and how many there are.
+		[[nodiscard]] inline auto cluster(weighted_graph const& g, std::size_t limit)
+		   -> std::pair<std::vector<std::uint32_t>, std::size_t> {
+			constexpr auto rounds = 3;
+			auto const n = g.size();
+			auto label = std::vector<std::uint32_t>(n);
+			auto cluster_weight = g.weight;
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				label[v] = static_cast<std::uint32_t>(v);
+			}
+			auto count = connection_count(n);
+			for (auto round = 0; round < rounds; ++round) {
+				for (auto v = node_id{0}; v < n; ++v) {
+					count.add(g, v, label);
+					auto best = label[v];
+					for (auto const c : count.touched()) {
+						if (count[c] > count[best] and cluster_weight[c] + g.weight[v] <= limit) {
+							best = c;
+						}
+					}
+					cluster_weight[label[v]] -= g.weight[v];
+					cluster_weight[best] += g.weight[v];
+					label[v] = best;
+				}
+			}
+			auto dense = std::vector<std::uint32_t>(n, connection_count::unlabelled);
+			auto clusters = std::size_t{0};
+			for (auto& l : label) {
+				if (dense[l] == connection_count::unlabelled) {
+					dense[l] = static_cast<std::uint32_t>(clusters++);
+				}
+				l = dense[l];
+			}
+			return {std::move(label), clusters};
+		}
+
+		// one node per cluster, weighing as much as its members, with the edges between clusters
+		[[nodiscard]] inline auto contract(weighted_graph const& g,
+		                                   std::vector<std::uint32_t> const& label,
+		                                   std::size_t clusters) -> weighted_graph {
+			auto weight = std::vector<std::size_t>(clusters, 0);
+			auto edges = std::vector<std::tuple<node_id, node_id, std::size_t>>{};
+			edges.reserve(g.targets.size());
+			for (auto v = node_id{0}; v < g.size(); ++v) {
+				weight[label[v]] += g.weight[v];
+				for (auto e = g.offsets[v]; e != g.offsets[v + 1]; ++e) {
+					edges.emplace_back(label[v], label[g.targets[e]], g.edge_weight[e]);
+				}
+			}
+			return make_weighted_graph(std::move(weight), std::move(edges));
+		}
+
+		// greedy moves: each node in turn goes to the part it has the heaviest edges into, if that
+		// is heavier than into its own part and the part has room. Every move strictly lowers
+		// the cut, so the passes would stop by themselves too.
+		inline auto refine(weighted_graph const& g,
+		                   std::vector<std::uint32_t>& part,
+		                   std::vector<std::size_t>& size,
+		                   std::size_t capacity,
+		                   std::size_t passes) -> void {
+			auto count = connection_count(size.size());
+			for (auto pass = std::size_t{0}; pass < passes; ++pass) {
+				auto moved = false;
+				for (auto v = node_id{0}; v < g.size(); ++v) {
+					count.add(g, v, part);
+					auto const from = part[v];
+					auto best = from;
+					for (auto const p : count.touched()) {
+						if (count[p] > count[best] and size[p] + g.weight[v] <= capacity) {
+							best = p;
+						}
+					}
+					if (best != from) {
+						size[from] -= g.weight[v];
+						size[best] += g.weight[v];
+						part[v] = best;
+						moved = true;
+					}
+				}
+				if (!moved) {
+					return;
+				}
+			}
+		}
+
+		// streams the nodes in order, placing each in the part with the best score (see
+		// partition). A node that fits nowhere goes to the lightest part.
+		[[nodiscard]] inline auto stream(weighted_graph const& g,
+		                                 std::size_t k,
+		                                 std::size_t capacity,
+		                                 partition_options const& opts)
+		   -> std::pair<std::vector<std::uint32_t>, std::vector<std::size_t>> {
+			auto total_weight = std::size_t{0};
+			for (auto const w : g.weight) {
+				total_weight += w;
+			}
+			auto total_edges = std::size_t{0};
+			for (auto const w : g.edge_weight) {
+				total_edges += w;
+			}
+			auto const alpha = static_cast<double>(total_edges / 2)
+			                   * std::pow(static_cast<double>(k), opts.gamma - 1)
+			                   / std::pow(static_cast<double>(total_weight), opts.gamma);
+			auto part = std::vector<std::uint32_t>(g.size(), connection_count::unlabelled);
+			auto size = std::vector<std::size_t>(k, 0);
+			auto count = connection_count(k);
+			// what placing v in p is worth: the edges it keeps inside p, less the growth in p's
+			// size penalty
+			auto score = [&](node_id v, std::size_t p) {
+				auto const s = static_cast<double>(size[p]);
+				auto const c = static_cast<double>(count[p]);
+				if (opts.method == partition_method::ldg) {
+					return c * (1.0 - s / static_cast<double>(capacity));
+				}
+				auto const w = static_cast<double>(g.weight[v]);
+				return c - alpha * (std::pow(s + w, opts.gamma) - std::pow(s, opts.gamma));
+			};
+			for (auto v = node_id{0}; v < g.size(); ++v) {
+				count.add(g, v, part);
+				auto best = k;
+				auto best_score = 0.0;
+				for (auto p = std::size_t{0}; p < k; ++p) {
+					if (size[p] + g.weight[v] > capacity) {
+						continue;
+					}
+					// ties go to the lighter part, then the lower number
+					auto const s = score(v, p);
+					if (best == k or s > best_score or (s == best_score and size[p] < size[best])) {
+						best = p;
+						best_score = s;
+					}
+				}
+				if (best == k) {
+					best = static_cast<std::size_t>(std::min_element(size.begin(), size.end())
+					                                - size.begin());
+				}
+				part[v] = static_cast<std::uint32_t>(best);
+				size[best] += g.weight[v];
+			}
+			return {std::move(part), std::move(size)};
+		}
+	} // namespace detail
+
+	// ============
+	// PARTITIONING
+	// ------------
+
+	// Multilevel, with a streaming partitioner at the bottom. The graph (its edges taken in both
+	// directions) is coarsened by contracting clusters found with size-constrained label
+	// propagation, level after level, until it is small or stops shrinking. The coarsest graph
+	// is streamed once, each node going to the part that holds most of its already placed
+	// neighbours after a penalty for the part's size (Fennel or LDG). The parts are then
+	// carried back down, refined at each level by greedy moves that lower the cut while keeping
+	// every part within capacity. About O((V + E) log E) per level.
+	//
+	// Throws std::invalid_argument if k is 0 or the imbalance is below 1.
+	template<typename N, typename E>
+	[[nodiscard]] auto partition(frozen_graph<N, E> const& g,
+	                             std::size_t k,
+	                             partition_options const& opts = {}) -> partitioning {
+		if (k == 0 or !(opts.imbalance >= 1.0)) {
+			throw std::invalid_argument("Cannot call gdwg::algorithms::partition with no parts or an "
+			                            "imbalance below 1");
+		}
+		auto const n = g.size();
+		auto result = partitioning{k, {}, 0};
+		if (n == 0) {
+			return result;
+		}
+		auto edges = std::vector<std::tuple<node_id, node_id, std::size_t>>{};
+		edges.reserve(2 * g.edge_count());
+		for (auto from = node_id{0}; from < n; ++from) {
+			for (auto const to : g.out_edges(from)) {
+				edges.emplace_back(from, to, 1);
+				edges.emplace_back(to, from, 1);
+			}
+		}
+		auto levels = std::vector<detail::weighted_graph>{};
+		levels.push_back(
+		   detail::make_weighted_graph(std::vector<std::size_t>(n, 1), std::move(edges)));
+		auto const even = static_cast<double>(n) / static_cast<double>(k);
+		auto const capacity =
+		   std::max((n + k - 1) / k, static_cast<std::size_t>(opts.imbalance * even));
+
+		// clusters are kept to a fraction of a part, so the streaming has room to balance them
+		auto maps = std::vector<std::vector<std::uint32_t>>{};
+		while (opts.coarsen and levels.back().size() > 8 * k) {
+			auto const limit = std::max<std::size_t>(1, capacity / 4);
+			auto [label, clusters] = detail::cluster(levels.back(), limit);
+			if (clusters * 10 > levels.back().size() * 9) {
+				break; // hardly shrinking any more
+			}
+			levels.push_back(detail::contract(levels.back(), label, clusters));
+			maps.push_back(std::move(label));
+		}
+
+		auto [part, size] = detail::stream(levels.back(), k, capacity, opts);
+		detail::refine(levels.back(), part, size, capacity, opts.refinement_passes);
+		for (auto level = maps.size(); level-- != 0;) {
+			auto fine = std::vector<std::uint32_t>(maps[level].size());
+			for (auto v = std::size_t{0}; v < fine.size(); ++v) {
+				fine[v] = part[maps[level][v]];
+			}
+			part = std::move(fine);
+			detail::refine(levels[level], part, size, capacity, opts.refinement_passes);
+		}
+
+		result.part = std::move(part);
+		for (auto from = node_id{0}; from < n; ++from) {
+			for (auto const to : g.out_edges(from)) {
+				result.edge_cut += result.part[from] != result.part[to] ? 1 : 0;
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto partition(graph<N, E> const& g,
+	                             std::size_t k,
+	                             partition_options const& opts = {}) -> partitioning {
+		return partition(g.freeze(), k, opts);
+	}
+
+	// =================
+	// SPLITTING A GRAPH
+	// -----------------
+
+	// builds the graph and boundary metadata of every part of p, which must come from
+	// partition(g, ...)
+	template<typename N, typename E>
+	[[nodiscard]] auto split(frozen_graph<N, E> const& g, partitioning const& p)
+	   -> std::vector<graph_part<N, E>> {
+		auto const n = g.size();
+		auto parts = std::vector<graph_part<N, E>>(p.parts);
+		auto edges = std::vector<std::vector<typename graph<N, E>::value_type>>(p.parts);
+		auto boundary = std::vector<bool>(n, false);
+		auto ghosts = std::vector<std::vector<node_id>>(p.parts);
+		for (auto from = node_id{0}; from < n; ++from) {
+			auto const owner = p.part[from];
+			auto const targets = g.out_edges(from);
+			auto const weights = g.out_weights(from);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				auto const to = targets[i];
+				edges[owner].push_back({g.node(from), g.node(to), weights[i]});
+				if (p.part[to] != owner) {
+					boundary[from] = boundary[to] = true;
+					ghosts[owner].push_back(to);
+				}
+			}
+		}
+		// node ids are in sorted order, so lists filled in id order come out sorted
+		for (auto v = node_id{0}; v < n; ++v) {
+			auto& part = parts[p.part[v]];
+			part.owned.push_back(g.node(v));
+			if (boundary[v]) {
+				part.boundary.push_back(g.node(v));
+			}
+		}
+		for (auto i = std::size_t{0}; i < p.parts; ++i) {
+			auto& part = parts[i];
+			part.g = graph<N, E>(edges[i].begin(), edges[i].end());
+			for (auto const& v : part.owned) {
+				part.g.insert_node(v); // the ones without edges
+			}
+			std::sort(ghosts[i].begin(), ghosts[i].end());
+			ghosts[i].erase(std::unique(ghosts[i].begin(), ghosts[i].end()), ghosts[i].end());
+			for (auto const v : ghosts[i]) {
+				part.ghosts.emplace_back(g.node(v), p.part[v]);
+			}
+		}
+		return parts;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto split(graph<N, E> const& g, partitioning const& p)
+	   -> std::vector<graph_part<N, E>> {
+		return split(g.freeze(), p);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_PARTITION_HPP
@@ -0,0 +1,160 @@
+#ifndef GDWG_ALGORITHMS_REORDER_HPP
+#define GDWG_ALGORITHMS_REORDER_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	enum class node_ordering {
+		// reverse Cuthill-McKee: breadth first from a low degree node, neighbours taken lowest
+		// degree first, then reversed. Keeps the ids of neighbours close together (a narrow band
+		// around the diagonal of the adjacency matrix).
+		reverse_cuthill_mckee,
+		// highest degree first, so the hubs that most edges lead to share a few cache lines
+		degree_descending,
+		// breadth first, each component from its lowest id, as traversals will visit the nodes
+		breadth_first,
+	};
+
+	namespace detail {
+		// the neighbours of each node with edges taken both ways, as CSR offsets and targets (self
+		// loops and parallel edges included), so degree(v) is v's in + out degree
+		struct undirected_adjacency {
+			std::vector<std::size_t> offsets{};
+			std::vector<node_id> targets{};
+
+			[[nodiscard]] auto degree(node_id v) const -> std::size_t {
+				return offsets[v + 1] - offsets[v];
+			}
+		};
+
+		template<typename N, typename E>
+		[[nodiscard]] auto make_undirected_adjacency(frozen_graph<N, E> const& g)
+		   -> undirected_adjacency {
+			auto const n = g.size();
+			auto const& out_offsets = g.offsets();
+			auto const& out_targets = g.targets();
+			auto result = undirected_adjacency{std::vector<std::size_t>(n + 1, 0), {}};
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				result.offsets[v + 1] += out_offsets[v + 1] - out_offsets[v];
+			}
+			for (auto const t : out_targets) {
+				++result.offsets[t + 1];
+			}
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				result.offsets[v + 1] += result.offsets[v];
+			}
+			auto next = std::vector<std::size_t>(result.offsets.begin(), result.offsets.end() - 1);
+			result.targets.resize(result.offsets.back());
+			for (auto from = node_id{0}; from < n; ++from) {
+				for (auto const to : g.out_edges(from)) {
+					result.targets[next[from]++] = to;
+					result.targets[next[to]++] = from;
+				}
+			}
+			return result;
+		}
+
+		// appends the nodes reachable from root that aren't yet seen, breadth first; with
+		// by_degree, each node's neighbours are queued lowest degree first
+		inline auto breadth_first(undirected_adjacency const& adjacency,
+		                          node_id root,
+		                          bool by_degree,
+		                          std::vector<bool>& seen,
+		                          std::vector<node_id>& order) -> void {
+			seen[root] = true;
+			order.push_back(root);
+			for (auto next = order.size() - 1; next != order.size(); ++next) {
+				auto const v = order[next];
+				auto const first = order.size();
+				for (auto e = adjacency.offsets[v]; e != adjacency.offsets[v + 1]; ++e) {
+					auto const w = adjacency.targets[e];
+					if (!seen[w]) {
+						seen[w] = true;
+						order.push_back(w);
+					}
+				}
+				if (by_degree) {
+					std::stable_sort(order.begin() + static_cast<std::ptrdiff_t>(first),
+					                 order.end(),
+					                 [&](node_id a, node_id b) {
+						                 return adjacency.degree(a) < adjacency.degree(b);
+					                 });
+				}
+			}
+		}
+	} // namespace detail
+
+	// =================
+	// LOCALITY ORDERING
+	// -----------------
+
+	// a new numbering of g's nodes: order[i] is the id of the node that becomes node i. Edges are
+	// taken both ways. O(V + E), plus sorting for reverse Cuthill-McKee and degree order.
+	template<typename N, typename E>
+	[[nodiscard]] auto ordering(frozen_graph<N, E> const& g, node_ordering strategy)
+	   -> std::vector<node_id> {
+		auto const n = g.size();
+		auto const adjacency = detail::make_undirected_adjacency(g);
+		auto order = std::vector<node_id>{};
+		order.reserve(n);
+		auto by_degree = std::vector<node_id>(n);
+		for (auto v = node_id{0}; v < n; ++v) {
+			by_degree[v] = v;
+		}
+
+		switch (strategy) {
+		case node_ordering::reverse_cuthill_mckee: {
+			// each component starts from its lowest degree node, which tends to be near its edge
+			std::stable_sort(by_degree.begin(), by_degree.end(), [&](node_id a, node_id b) {
+				return adjacency.degree(a) < adjacency.degree(b);
+			});
+			auto seen = std::vector<bool>(n, false);
+			for (auto const root : by_degree) {
+				if (!seen[root]) {
+					detail::breadth_first(adjacency, root, true, seen, order);
+				}
+			}
+			std::reverse(order.begin(), order.end());
+			break;
+		}
+		case node_ordering::degree_descending:
+			std::stable_sort(by_degree.begin(), by_degree.end(), [&](node_id a, node_id b) {
+				return adjacency.degree(a) > adjacency.degree(b);
+			});
+			order = std::move(by_degree);
+			break;
+		case node_ordering::breadth_first: {
+			auto seen = std::vector<bool>(n, false);
+			for (auto root = node_id{0}; root < n; ++root) {
+				if (!seen[root]) {
+					detail::breadth_first(adjacency, root, false, seen, order);
+				}
+			}
+			break;
+		}
+		}
+		return order;
+	}
+
+	// g with its nodes renumbered for locality (see frozen_graph::permute). Results of algorithms
+	// run on it are indexed by the new ids; node(i) gives the value of node i as always.
+	template<typename N, typename E>
+	[[nodiscard]] auto reorder(frozen_graph<N, E> const& g, node_ordering strategy)
+	   -> frozen_graph<N, E> {
+		return g.permute(ordering(g, strategy));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto reorder(graph<N, E> const& g, node_ordering strategy) -> frozen_graph<N, E> {
+		return reorder(g.freeze(), strategy);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_REORDER_HPP
@@ -0,0 +1,329 @@
+#ifndef GDWG_ALGORITHMS_SHORTEST_PATHS_HPP
+#define GDWG_ALGORITHMS_SHORTEST_PATHS_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	// the answer to one point-to-point query. nodes runs from src to dst and points into the
+	// path_search's own storage, so it is only valid until its next query.
+	template<typename E>
+	struct path_result {
+		bool found = false;
+		E distance{};
+		std::span<node_id const> nodes{};
+		std::size_t settled = 0; // nodes taken off the heaps, a measure of the work done
+	};
+
+	// a shortest path between two values of a graph
+	template<typename N, typename E>
+	struct weighted_path {
+		E distance{};
+		std::vector<N> nodes{};
+		[[nodiscard]] auto operator==(weighted_path const& other) const -> bool = default;
+	};
+
+	namespace detail {
+		// The state of one direction of a search. Distances, parents and the settled marks are
+		// only valid for nodes whose stamp is the current generation, so starting a query is one
+		// increment instead of clearing arrays of size V, and the heap keeps its capacity from one
+		// query to the next. Once the search has warmed up, a query allocates nothing.
+		template<typename E>
+		class search_frontier {
+		public:
+			explicit search_frontier(std::size_t n)
+			: distance_(n)
+			, parent_(n)
+			, reached_(n, 0)
+			, settled_(n, 0) {}
+
+			auto reset(std::uint32_t generation) -> void {
+				generation_ = generation;
+				heap_.clear();
+			}
+			// stamps from a generation that wrapped around are dropped, once every 2^32 queries
+			auto forget() -> void {
+				std::fill(reached_.begin(), reached_.end(), 0);
+				std::fill(settled_.begin(), settled_.end(), 0);
+			}
+
+			[[nodiscard]] auto reached(node_id v) const noexcept -> bool {
+				return reached_[v] == generation_;
+			}
+			[[nodiscard]] auto settled(node_id v) const noexcept -> bool {
+				return settled_[v] == generation_;
+			}
+			[[nodiscard]] auto distance(node_id v) const noexcept -> E const& {
+				return distance_[v];
+			}
+			[[nodiscard]] auto parent(node_id v) const noexcept -> node_id {
+				return parent_[v];
+			}
+
+			// lowers v's distance to d (through parent) if that is shorter; key is d plus whatever
+			// the caller orders the heap by
+			auto relax(node_id v, E const& d, node_id parent, E const& key) -> bool {
+				if (reached(v) and !(d < distance_[v])) {
+					return false;
+				}
+				reached_[v] = generation_;
+				distance_[v] = d;
+				parent_[v] = parent;
+				heap_.push_back({key, v});
+				std::push_heap(heap_.begin(), heap_.end(), later);
+				return true;
+			}
+
+			// drops entries that a shorter distance has since replaced (the heap is lazy), so top()
+			// is the next node to settle
+			auto skip_stale() -> void {
+				while (!heap_.empty() and settled(heap_.front().second)) {
+					std::pop_heap(heap_.begin(), heap_.end(), later);
+					heap_.pop_back();
+				}
+			}
+			[[nodiscard]] auto empty() const noexcept -> bool {
+				return heap_.empty();
+			}
+			[[nodiscard]] auto top() const noexcept -> std::pair<E, node_id> const& {
+				return heap_.front();
+			}
+			auto settle_top() -> node_id {
+				auto const v = heap_.front().second;
+				std::pop_heap(heap_.begin(), heap_.end(), later);
+				heap_.pop_back();
+				settled_[v] = generation_;
+				return v;
+			}
+
+		private:
+			[[nodiscard]] static auto later(std::pair<E, node_id> const& x,
+			                                std::pair<E, node_id> const& y) -> bool {
+				return y.first < x.first;
+			}
+
+			std::vector<E> distance_;
+			std::vector<node_id> parent_;
+			std::vector<std::uint32_t> reached_;
+			std::vector<std::uint32_t> settled_;
+			std::vector<std::pair<E, node_id>> heap_{};
+			std::uint32_t generation_ = 0;
+		};
+	} // namespace detail
+
+	//   ==================
+	//   PATH SEARCH CLASS
+	//   ------------------
+	//
+	// Point-to-point shortest paths on a frozen graph, for answering many queries one after
+	// another. Both searches stop as soon as the path to dst is known instead of settling the
+	// whole graph:
+	//   * bidirectional Dijkstra searches forward from src and backward from dst (over the
+	//     transpose, built once by the constructor) and stops when the two heaps' minimums add up
+	//     to no less than the best meeting point found, which usually settles far fewer nodes than
+	//     a one-sided search;
+	//   * A* searches forward only, ordered by distance plus a caller's estimate of the distance
+	//     left to dst. The estimate must be consistent (h(u) <= w + h(v) for every edge u -> v,
+	//     and h(dst) == 0), as straight-line distance is on a map; with h = 0 it is Dijkstra.
+	//
+	// Weights are the distances, so E must be arithmetic and no weight may be negative. The
+	// search keeps its state between queries (see detail::search_frontier) and reuses it, so one
+	// path_search is used by one thread at a time; give each thread its own.
+	template<typename N, typename E>
+	class path_search {
+		static_assert(std::is_arithmetic_v<E>, "path_search needs arithmetic edge weights");
+
+	public:
+		explicit path_search(frozen_graph<N, E> const& g)
+		: graph_{&g}
+		, reverse_{g.transpose()}
+		, forward_(g.size())
+		, backward_(g.size()) {
+			auto const negative = [](E const& w) { return w < E{}; };
+			if (std::any_of(g.weights().begin(), g.weights().end(), negative)) {
+				throw std::invalid_argument("Cannot call gdwg::algorithms::path_search with a negative "
+				                            "edge weight");
+			}
+		}
+
+		// the shortest path from src to dst by bidirectional Dijkstra
+		[[nodiscard]] auto bidirectional_dijkstra(node_id src, node_id dst) -> path_result<E> {
+			check(src, dst, "bidirectional_dijkstra");
+			start();
+			if (src == dst) {
+				return single(src);
+			}
+			auto result = path_result<E>{};
+			forward_.relax(src, E{}, src, E{});
+			backward_.relax(dst, E{}, dst, E{});
+			auto best = std::optional<E>{};
+			auto meet = src;
+			// relaxes v's edges in one direction, noting every path that joins the other direction
+			auto expand = [&](frozen_graph<N, E> const& edges,
+			                  detail::search_frontier<E>& here,
+			                  detail::search_frontier<E> const& there) {
+				auto const v = here.settle_top();
+				++result.settled;
+				auto const targets = edges.out_edges(v);
+				auto const weights = edges.out_weights(v);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					auto const to = targets[i];
+					auto const d = static_cast<E>(here.distance(v) + weights[i]);
+					here.relax(to, d, v, d);
+					if (there.reached(to)) {
+						auto const total = static_cast<E>(here.distance(to) + there.distance(to));
+						if (!best or total < *best) {
+							best = total;
+							meet = to;
+						}
+					}
+				}
+			};
+			while (true) {
+				forward_.skip_stale();
+				backward_.skip_stale();
+				if (forward_.empty() or backward_.empty()) {
+					break;
+				}
+				if (best and !(forward_.top().first + backward_.top().first < *best)) {
+					break;
+				}
+				if (!(backward_.top().first < forward_.top().first)) {
+					expand(*graph_, forward_, backward_);
+				}
+				else {
+					expand(reverse_, backward_, forward_);
+				}
+			}
+			if (!best) {
+				return result;
+			}
+			result.found = true;
+			result.distance = *best;
+			result.nodes = trace(src, meet, dst);
+			return result;
+		}
+
+		// the shortest path from src to dst by A*, where h(v) estimates the distance from v to dst
+		template<typename Heuristic>
+		requires std::is_invocable_r_v<E, Heuristic&, node_id>
+		[[nodiscard]] auto a_star(node_id src, node_id dst, Heuristic h) -> path_result<E> {
+			check(src, dst, "a_star");
+			start();
+			auto result = path_result<E>{};
+			forward_.relax(src, E{}, src, std::invoke(h, src));
+			while (true) {
+				forward_.skip_stale();
+				if (forward_.empty()) {
+					return result;
+				}
+				auto const v = forward_.settle_top();
+				++result.settled;
+				if (v == dst) {
+					break;
+				}
+				auto const targets = graph_->out_edges(v);
+				auto const weights = graph_->out_weights(v);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					auto const to = targets[i];
+					if (forward_.settled(to)) {
+						continue;
+					}
+					auto const d = static_cast<E>(forward_.distance(v) + weights[i]);
+					if (!forward_.reached(to) or d < forward_.distance(to)) {
+						forward_.relax(to, d, v, static_cast<E>(d + std::invoke(h, to)));
+					}
+				}
+			}
+			result.found = true;
+			result.distance = forward_.distance(dst);
+			result.nodes = trace(src, dst, dst);
+			return result;
+		}
+
+	private:
+		auto check(node_id src, node_id dst, char const* method) const -> void {
+			if (src >= graph_->size() or dst >= graph_->size()) {
+				throw std::out_of_range(std::string("Cannot call gdwg::algorithms::path_search::")
+				                        + method + " on a node that doesn't exist in the graph");
+			}
+		}
+
+		auto start() -> void {
+			if (++generation_ == 0) {
+				forward_.forget();
+				backward_.forget();
+				generation_ = 1;
+			}
+			forward_.reset(generation_);
+			backward_.reset(generation_);
+			path_.clear();
+		}
+
+		[[nodiscard]] auto single(node_id v) -> path_result<E> {
+			path_.push_back(v);
+			return {true, E{}, path_, 1};
+		}
+
+		// src to meet along the forward parents, then meet to dst along the backward ones
+		[[nodiscard]] auto trace(node_id src, node_id meet, node_id dst) -> std::span<node_id const> {
+			for (auto v = meet; v != src; v = forward_.parent(v)) {
+				path_.push_back(v);
+			}
+			path_.push_back(src);
+			std::reverse(path_.begin(), path_.end());
+			for (auto v = meet; v != dst;) {
+				v = backward_.parent(v);
+				path_.push_back(v);
+			}
+			return path_;
+		}
+
+		frozen_graph<N, E> const* graph_;
+		frozen_graph<N, E> reverse_;
+		detail::search_frontier<E> forward_;
+		detail::search_frontier<E> backward_;
+		std::vector<node_id> path_{};
+		std::uint32_t generation_ = 0;
+	};
+
+	// One shortest path between two values by bidirectional Dijkstra, or nullopt if dst can't be
+	// reached from src. This freezes the graph and builds a path_search for a single query; to
+	// answer many, build one path_search and keep it.
+	template<typename N, typename E>
+	[[nodiscard]] auto shortest_path(graph<N, E> const& g, N const& src, N const& dst)
+	   -> std::optional<weighted_path<N, E>> {
+		if (!g.is_node(src) or !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::algorithms::shortest_path if src or dst node "
+			                         "don't exist in the graph");
+		}
+		auto const frozen = g.freeze();
+		auto search = path_search<N, E>(frozen);
+		auto const found = search.bidirectional_dijkstra(frozen.id(src), frozen.id(dst));
+		if (!found.found) {
+			return std::nullopt;
+		}
+		auto result = weighted_path<N, E>{found.distance, {}};
+		result.nodes.reserve(found.nodes.size());
+		for (auto const v : found.nodes) {
+			result.nodes.push_back(frozen.node(v));
+		}
+		return result;
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_SHORTEST_PATHS_HPP
@@ -0,0 +1,219 @@
+#ifndef GDWG_ALGORITHMS_SPANNING_FOREST_HPP
+#define GDWG_ALGORITHMS_SPANNING_FOREST_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	// an edge of a spanning forest, in the direction it has in the graph
+	template<typename E>
+	struct forest_edge {
+		node_id from;
+		node_id to;
+		E weight;
+		[[nodiscard]] auto operator==(forest_edge const& other) const -> bool = default;
+	};
+
+	enum class mst_algorithm {
+		automatic, // Boruvka for large graphs on a multi-threaded pool, otherwise Kruskal
+		kruskal,
+		boruvka,
+	};
+
+	namespace detail {
+		// the (weight, src, dst) order both algorithms use
+		template<typename E>
+		[[nodiscard]] auto lighter(forest_edge<E> const& x, forest_edge<E> const& y) -> bool {
+			return std::tie(x.weight, x.from, x.to) < std::tie(y.weight, y.from, y.to);
+		}
+
+		// the lightest edge of each (src, dst) pair, ignoring self loops. The frozen graph keeps a
+		// pair's parallel edges together and sorted by weight, so that is just the first of each
+		// run. They are sorted lighter-first, which is a strict total order, so both algorithms break
+		// ties the same way and always pick the same forest.
+		template<typename N, typename E>
+		[[nodiscard]] auto spanning_candidates(frozen_graph<N, E> const& g)
+		   -> std::vector<forest_edge<E>> {
+			auto candidates = std::vector<forest_edge<E>>{};
+			for (auto from = node_id{0}; from < g.size(); ++from) {
+				auto const targets = g.out_edges(from);
+				auto const weights = g.out_weights(from);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					if (targets[i] != from and (i == 0 or targets[i - 1] != targets[i])) {
+						candidates.push_back({from, targets[i], weights[i]});
+					}
+				}
+			}
+			gdwg::detail::parallel_sort(candidates, lighter<E>);
+			return candidates;
+		}
+
+		// sequential union-find with path halving and union by size
+		class disjoint_sets {
+		public:
+			explicit disjoint_sets(std::size_t n)
+			: parent_(n)
+			, size_(n, 1) {
+				std::iota(parent_.begin(), parent_.end(), node_id{0});
+			}
+			[[nodiscard]] auto find(node_id x) noexcept -> node_id {
+				while (parent_[x] != x) {
+					parent_[x] = parent_[parent_[x]];
+					x = parent_[x];
+				}
+				return x;
+			}
+			// find without path halving, safe to call from many threads while nothing is merged
+			[[nodiscard]] auto find_root(node_id x) const noexcept -> node_id {
+				while (parent_[x] != x) {
+					x = parent_[x];
+				}
+				return x;
+			}
+			auto merge(node_id a, node_id b) noexcept -> bool {
+				a = find(a);
+				b = find(b);
+				if (a == b) {
+					return false;
+				}
+				if (size_[a] < size_[b]) {
+					std::swap(a, b);
+				}
+				parent_[b] = a;
+				size_[a] += size_[b];
+				return true;
+			}
+
+		private:
+			std::vector<node_id> parent_;
+			std::vector<std::size_t> size_;
+		};
+
+		template<typename E>
+		[[nodiscard]] auto kruskal(std::size_t n, std::vector<forest_edge<E>> const& candidates)
+		   -> std::vector<forest_edge<E>> {
+			auto sets = disjoint_sets(n);
+			auto forest = std::vector<forest_edge<E>>{};
+			for (auto const& e : candidates) {
+				if (forest.size() + 1 == n) {
+					break;
+				}
+				if (sets.merge(e.from, e.to)) {
+					forest.push_back(e);
+				}
+			}
+			return forest;
+		}
+
+		// In each round every component picks its lightest outgoing edge; the picks are made in
+		// parallel over the candidates with an atomic minimum on the candidate's index, which is
+		// the same as the lightest edge since the candidates are sorted. The picks are then merged
+		// sequentially, and edges inside one component are dropped before the next round.
+		template<typename E>
+		[[nodiscard]] auto boruvka(std::size_t n,
+		                           std::vector<forest_edge<E>> candidates,
+		                           thread_pool& pool) -> std::vector<forest_edge<E>> {
+			constexpr auto none = std::numeric_limits<std::size_t>::max();
+			auto sets = disjoint_sets(n);
+			auto forest = std::vector<forest_edge<E>>{};
+			auto lightest = std::vector<std::atomic<std::size_t>>(n);
+			auto pick = [&](node_id component, std::size_t i) {
+				auto current = lightest[component].load(std::memory_order_relaxed);
+				while (i < current
+				       and !lightest[component].compare_exchange_weak(current,
+				                                                      i,
+				                                                      std::memory_order_relaxed))
+				{
+				}
+			};
+			while (!candidates.empty()) {
+				pool.parallel_for(n, [&](std::size_t first, std::size_t last) {
+					for (; first != last; ++first) {
+						lightest[first].store(none, std::memory_order_relaxed);
+					}
+				});
+				pool.parallel_for(candidates.size(), [&](std::size_t first, std::size_t last) {
+					for (; first != last; ++first) {
+						auto const a = sets.find_root(candidates[first].from);
+						auto const b = sets.find_root(candidates[first].to);
+						if (a != b) {
+							pick(a, first);
+							pick(b, first);
+						}
+					}
+				});
+				auto merged = false;
+				for (auto component = node_id{0}; component < n; ++component) {
+					auto const i = lightest[component].load(std::memory_order_relaxed);
+					if (i != none and sets.merge(candidates[i].from, candidates[i].to)) {
+						forest.push_back(candidates[i]);
+						merged = true;
+					}
+				}
+				if (!merged) {
+					break;
+				}
+				std::erase_if(candidates, [&](forest_edge<E> const& e) {
+					return sets.find(e.from) == sets.find(e.to);
+				});
+			}
+			std::sort(forest.begin(), forest.end(), lighter<E>); // same order as kruskal
+			return forest;
+		}
+	} // namespace detail
+
+	// ==========================
+	// MINIMUM SPANNING FOREST
+	// --------------------------
+
+	// the edges of a minimum spanning forest of g, with edge direction ignored: one minimum
+	// spanning tree per weakly connected component. Parallel edges only contribute their lightest
+	// weight and self loops are never used. Edges are listed lightest first.
+	template<typename N, typename E>
+	[[nodiscard]] auto minimum_spanning_edges(frozen_graph<N, E> const& g,
+	                                          mst_algorithm algorithm = mst_algorithm::automatic,
+	                                          thread_pool& pool = thread_pool::shared())
+	   -> std::vector<forest_edge<E>> {
+		auto candidates = detail::spanning_candidates(g);
+		if (algorithm == mst_algorithm::automatic) {
+			algorithm = pool.size() > 1 and candidates.size() >= 4 * gdwg::detail::parallel_threshold
+			               ? mst_algorithm::boruvka
+			               : mst_algorithm::kruskal;
+		}
+		if (algorithm == mst_algorithm::boruvka) {
+			return detail::boruvka(g.size(), std::move(candidates), pool);
+		}
+		return detail::kruskal(g.size(), candidates);
+	}
+
+	// the minimum spanning forest as a new graph, with every node of g and the forest's edges
+	template<typename N, typename E>
+	[[nodiscard]] auto minimum_spanning_forest(graph<N, E> const& g,
+	                                           mst_algorithm algorithm = mst_algorithm::automatic,
+	                                           thread_pool& pool = thread_pool::shared())
+	   -> graph<N, E> {
+		auto const frozen = g.freeze();
+		auto edges = std::vector<typename graph<N, E>::value_type>{};
+		for (auto const& e : minimum_spanning_edges(frozen, algorithm, pool)) {
+			edges.push_back({frozen.node(e.from), frozen.node(e.to), e.weight});
+		}
+		auto forest = graph<N, E>(edges.begin(), edges.end());
+		for (auto const& n : frozen.nodes()) {
+			forest.insert_node(n);
+		}
+		return forest;
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_SPANNING_FOREST_HPP
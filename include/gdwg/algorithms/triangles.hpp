@@ -0,0 +1,257 @@
+#ifndef GDWG_ALGORITHMS_TRIANGLES_HPP
+#define GDWG_ALGORITHMS_TRIANGLES_HPP
+
+#include "gdwg/algorithms/pagerank.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <absl/container/flat_hash_set.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace gdwg::algorithms {
+
+	namespace detail {
+		// a node whose oriented neighbour list is at least this long puts the list in a hash set
+		// and probes it, rather than merging it again with every neighbour's list
+		inline constexpr auto hash_intersection_degree = std::size_t{64};
+
+		// The graph as a simple undirected graph (edge direction, parallel edges and self loops
+		// ignored), with each edge kept only at the lower-ranked of its two ends. A node ranks
+		// by its degree, then its id, so high-degree nodes keep short lists, and every triangle
+		// is found exactly once: at its lowest-ranked node, through the other two.
+		struct oriented_adjacency {
+			std::vector<std::size_t> degree{}; // undirected degree
+			std::vector<std::size_t> offsets{};
+			std::vector<node_id> targets{}; // each row sorted by id
+		};
+
+		// calls f(w) for each distinct neighbour w != v of node v, in increasing order, by merging
+		// its out-edges (sorted in scratch if they aren't already) with its in-edges
+		template<typename F>
+		auto for_each_neighbour(node_id v,
+		                        std::span<node_id const> out,
+		                        std::span<node_id const> in,
+		                        std::vector<node_id>& scratch,
+		                        F f) -> void {
+			if (!std::is_sorted(out.begin(), out.end())) {
+				scratch.assign(out.begin(), out.end());
+				std::sort(scratch.begin(), scratch.end());
+				out = scratch;
+			}
+			auto previous = v;
+			auto emit = [&](node_id w) {
+				if (w != v and w != previous) {
+					f(w);
+				}
+				previous = w;
+			};
+			auto i = out.begin();
+			auto j = in.begin();
+			while (i != out.end() and j != in.end()) {
+				emit(*j < *i ? *j++ : *i++);
+			}
+			std::for_each(i, out.end(), emit);
+			std::for_each(j, in.end(), emit);
+		}
+
+		template<typename N, typename E>
+		[[nodiscard]] auto orient(frozen_graph<N, E> const& g, thread_pool& pool)
+		   -> oriented_adjacency {
+			auto const n = g.size();
+			// sources of each node's in-edges, in increasing order (a counting sort of the edges)
+			auto in_offsets = std::vector<std::size_t>(n + 1, 0);
+			for (auto const t : g.targets()) {
+				++in_offsets[t + 1];
+			}
+			std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
+			auto sources = std::vector<node_id>(g.edge_count());
+			auto next = std::vector<std::size_t>(in_offsets.begin(), in_offsets.end() - 1);
+			for (auto from = node_id{0}; from < n; ++from) {
+				for (auto const to : g.out_edges(from)) {
+					sources[next[to]++] = from;
+				}
+			}
+
+			auto result = oriented_adjacency{std::vector<std::size_t>(n),
+			                                 std::vector<std::size_t>(n + 1, 0),
+			                                 {}};
+			auto const neighbours = [&](node_id v, std::vector<node_id>& scratch, auto f) {
+				auto const in = std::span<node_id const>(sources.data() + in_offsets[v],
+				                                         in_offsets[v + 1] - in_offsets[v]);
+				for_each_neighbour(v, g.out_edges(v), in, scratch, f);
+			};
+			auto const higher = [&result](node_id w, node_id v) {
+				auto const& degree = result.degree;
+				return degree[w] > degree[v] or (degree[w] == degree[v] and w > v);
+			};
+			pool.parallel_for(n, [&](std::size_t v, std::size_t last) {
+				auto scratch = std::vector<node_id>{};
+				for (; v != last; ++v) {
+					neighbours(static_cast<node_id>(v), scratch, [&](node_id) { ++result.degree[v]; });
+				}
+			});
+			pool.parallel_for(n, [&](std::size_t v, std::size_t last) {
+				auto scratch = std::vector<node_id>{};
+				for (; v != last; ++v) {
+					auto const id = static_cast<node_id>(v);
+					neighbours(id, scratch, [&](node_id w) {
+						result.offsets[v + 1] += higher(w, id) ? 1 : 0;
+					});
+				}
+			});
+			std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+			result.targets.resize(result.offsets.back());
+			pool.parallel_for(n, [&](std::size_t v, std::size_t last) {
+				auto scratch = std::vector<node_id>{};
+				for (; v != last; ++v) {
+					auto const id = static_cast<node_id>(v);
+					auto slot = result.offsets[v];
+					neighbours(id, scratch, [&](node_id w) {
+						if (higher(w, id)) {
+							result.targets[slot++] = w;
+						}
+					});
+				}
+			});
+			return result;
+		}
+
+		// The number of triangles, found at each node v by intersecting its list with the list of
+		// each of its neighbours u: by a merge of the two sorted lists, or by probing a hash set of
+		// v's list when that is long. If per_node isn't empty, every triangle is also counted at
+		// each of its three nodes there. Blocks of nodes have about the same number of edges, so
+		// the few nodes with long lists don't all land in one block.
+		[[nodiscard]] inline auto count_triangles(oriented_adjacency const& adj,
+		                                          std::vector<std::uint64_t>& per_node,
+		                                          thread_pool& pool) -> std::uint64_t {
+			auto const& offsets = adj.offsets;
+			auto const& targets = adj.targets;
+			auto const row = [&](node_id v) {
+				auto const first = targets.data() + offsets[v];
+				return std::span<node_id const>(first, offsets[v + 1] - offsets[v]);
+			};
+			auto const credit = [&per_node](node_id x) {
+				std::atomic_ref(per_node[x]).fetch_add(1, std::memory_order_relaxed);
+			};
+			auto const blocks = std::max(std::size_t{1},
+			                             std::min(targets.size() / gdwg::detail::parallel_threshold,
+			                                      8 * pool.size()));
+			auto const bounds = edge_balanced_blocks(offsets, blocks);
+			auto partial = std::vector<std::uint64_t>(blocks, 0);
+			pool.parallel_for(
+			   blocks,
+			   [&](std::size_t block, std::size_t last) {
+				   auto hashed = absl::flat_hash_set<node_id>{};
+				   for (; block != last; ++block) {
+					   auto found = std::uint64_t{0};
+					   for (auto v = bounds[block]; v != bounds[block + 1]; ++v) {
+						   auto const id = static_cast<node_id>(v);
+						   auto const mine = row(id);
+						   auto const hash = mine.size() >= hash_intersection_degree;
+						   if (hash) {
+							   hashed.clear();
+							   hashed.insert(mine.begin(), mine.end());
+						   }
+						   for (auto const u : mine) {
+							   auto const theirs = row(u);
+							   auto const triangle = [&](node_id w) {
+								   ++found;
+								   if (!per_node.empty()) {
+									   credit(id);
+									   credit(u);
+									   credit(w);
+								   }
+							   };
+							   if (hash) {
+								   for (auto const w : theirs) {
+									   if (hashed.contains(w)) {
+										   triangle(w);
+									   }
+								   }
+								   continue;
+							   }
+							   auto i = mine.begin();
+							   auto j = theirs.begin();
+							   while (i != mine.end() and j != theirs.end()) {
+								   if (*i < *j) {
+									   ++i;
+								   }
+								   else if (*j < *i) {
+									   ++j;
+								   }
+								   else {
+									   triangle(*i);
+									   ++i;
+									   ++j;
+								   }
+							   }
+						   }
+					   }
+					   partial[block] = found;
+				   }
+			   },
+			   1);
+			return std::accumulate(partial.begin(), partial.end(), std::uint64_t{0});
+		}
+	} // namespace detail
+
+	// ===========
+	// TRIANGLES
+	// -----------
+
+	// The number of triangles in g taken as a simple undirected graph: three distinct nodes joined
+	// pairwise by an edge in either direction. Parallel edges and self loops don't add any.
+	// O(E^1.5) at worst, and parallel over the nodes.
+	template<typename N, typename E>
+	[[nodiscard]] auto triangle_count(frozen_graph<N, E> const& g,
+	                                  thread_pool& pool = thread_pool::shared()) -> std::uint64_t {
+		auto none = std::vector<std::uint64_t>{};
+		return detail::count_triangles(detail::orient(g, pool), none, pool);
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto triangle_count(graph<N, E> const& g,
+	                                  thread_pool& pool = thread_pool::shared()) -> std::uint64_t {
+		return triangle_count(g.freeze(), pool);
+	}
+
+	// The local clustering coefficient of each node (in frozen_graph / nodes() order), in g taken
+	// as a simple undirected graph as for triangle_count: the fraction of pairs of a node's
+	// neighbours that are themselves joined, 2 t / (d (d - 1)) for a node in t triangles with d
+	// neighbours, and 0 for a node with fewer than two neighbours.
+	template<typename N, typename E>
+	[[nodiscard]] auto clustering_coefficients(frozen_graph<N, E> const& g,
+	                                           thread_pool& pool = thread_pool::shared())
+	   -> std::vector<double> {
+		auto const adj = detail::orient(g, pool);
+		auto triangles = std::vector<std::uint64_t>(g.size(), 0);
+		static_cast<void>(detail::count_triangles(adj, triangles, pool));
+		auto result = std::vector<double>(g.size(), 0.0);
+		pool.parallel_for(g.size(), [&](std::size_t v, std::size_t last) {
+			for (; v != last; ++v) {
+				auto const d = static_cast<double>(adj.degree[v]);
+				if (adj.degree[v] >= 2) {
+					result[v] = 2.0 * static_cast<double>(triangles[v]) / (d * (d - 1.0));
+				}
+			}
+		});
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto clustering_coefficients(graph<N, E> const& g,
+	                                           thread_pool& pool = thread_pool::shared())
+	   -> std::vector<double> {
+		return clustering_coefficients(g.freeze(), pool);
+	}
+
+} // namespace gdwg::algorithms
+
+#endif // GDWG_ALGORITHMS_TRIANGLES_HPP
@@ -0,0 +1,198 @@
+#ifndef GDWG_ASYNC_QUERIES_HPP
+#define GDWG_ASYNC_QUERIES_HPP
+
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// the lookups a query_batcher can batch
+	enum class query_kind : std::uint8_t { connections, weights, is_connected };
+
+	//   ===================
+	//   QUERY BATCHER CLASS
+	//   -------------------
+	//
+	// Lookups on a graph for C++20 coroutines that are resolved in batches. co_await on
+	// async_connections, async_weights or async_is_connected suspends the caller and queues its
+	// query; run_pending() then resolves every queued query together and resumes the callers, so
+	// thousands of concurrent requests cost one pass rather than a blocked thread each.
+	//
+	// A batch is sorted by src (then kind and dst), so neighbouring lookups walk the same part of
+	// the graph's trees, and repeats of a query are resolved once. Large batches are split over
+	// the thread pool; callers are always resumed on the thread that called run_pending, in the
+	// sorted order. Queries fail as their graph methods do: the runtime_error is rethrown from
+	// the co_await.
+	//
+	// The batcher is driven by one thread (an event loop), and the graph must not change while
+	// queries are pending. Every query has to be run before the batcher is destroyed.
+	template<typename N, typename E>
+	class query_batcher {
+		struct query;
+
+	public:
+		// what co_await on one of the async_ calls waits on
+		template<query_kind Kind>
+		class awaitable {
+		public:
+			[[nodiscard]] auto await_ready() const noexcept -> bool {
+				return false;
+			}
+			auto await_suspend(std::coroutine_handle<> waiter) -> void {
+				query_.waiter = waiter;
+				owner_->pending_.push_back(&query_);
+			}
+			[[nodiscard]] auto await_resume() {
+				if (query_.error) {
+					std::rethrow_exception(query_.error);
+				}
+				if constexpr (Kind == query_kind::connections) {
+					return std::move(query_.nodes);
+				}
+				else if constexpr (Kind == query_kind::weights) {
+					return std::move(query_.weights);
+				}
+				else {
+					return static_cast<bool>(query_.connected);
+				}
+			}
+
+		private:
+			friend class query_batcher;
+			awaitable(query_batcher& owner, N src, N dst)
+			: owner_{&owner}
+			, query_{Kind, std::move(src), std::move(dst)} {}
+
+			query_batcher* owner_;
+			query query_;
+		};
+
+		// batches of at least this many queries are resolved on the thread pool
+		static constexpr auto parallel_batch = std::size_t{1024};
+
+		explicit query_batcher(graph<N, E> const& g, thread_pool& pool = thread_pool::shared())
+		: graph_{&g}
+		, pool_{&pool} {}
+
+		query_batcher(query_batcher const&) = delete;
+		query_batcher(query_batcher&&) = delete;
+		auto operator=(query_batcher const&) -> query_batcher& = delete;
+		auto operator=(query_batcher&&) -> query_batcher& = delete;
+		~query_batcher() = default;
+
+		// graph::connections(src)
+		[[nodiscard]] auto async_connections(N src) -> awaitable<query_kind::connections> {
+			return awaitable<query_kind::connections>(*this, std::move(src), N{});
+		}
+		// graph::weights(src, dst)
+		[[nodiscard]] auto async_weights(N src, N dst) -> awaitable<query_kind::weights> {
+			return awaitable<query_kind::weights>(*this, std::move(src), std::move(dst));
+		}
+		// graph::is_connected(src, dst)
+		[[nodiscard]] auto async_is_connected(N src, N dst) -> awaitable<query_kind::is_connected> {
+			return awaitable<query_kind::is_connected>(*this, std::move(src), std::move(dst));
+		}
+
+		// number of queries waiting for the next run_pending
+		[[nodiscard]] auto pending() const noexcept -> std::size_t {
+			return pending_.size();
+		}
+
+		// resolves the queries queued so far and resumes their callers. Queries those callers make
+		// once resumed are left for the next batch. Returns the number of queries resolved.
+		auto run_pending() -> std::size_t {
+			auto batch = std::exchange(pending_, {});
+			std::sort(batch.begin(), batch.end(), [](query const* x, query const* y) {
+				if (x->src < y->src or y->src < x->src) {
+					return x->src < y->src;
+				}
+				if (x->kind != y->kind) {
+					return x->kind < y->kind;
+				}
+				return x->dst < y->dst;
+			});
+			auto resolve_range = [&](std::size_t first, std::size_t last) {
+				auto const* previous = static_cast<query const*>(nullptr);
+				for (; first != last; ++first) {
+					auto& q = *batch[first];
+					if (previous != nullptr and same_lookup(*previous, q)) {
+						q.copy_result(*previous);
+					}
+					else {
+						q.resolve(*graph_);
+					}
+					previous = &q;
+				}
+			};
+			if (batch.size() < parallel_batch) {
+				resolve_range(0, batch.size());
+			}
+			else {
+				pool_->parallel_for(batch.size(), resolve_range, parallel_batch / 4);
+			}
+			for (auto* q : batch) {
+				q->waiter.resume();
+			}
+			return batch.size();
+		}
+
+		// runs batches until no query is pending; returns the number of queries resolved
+		auto run() -> std::size_t {
+			auto resolved = std::size_t{0};
+			while (!pending_.empty()) {
+				resolved += run_pending();
+			}
+			return resolved;
+		}
+
+	private:
+		struct query {
+			query_kind kind;
+			N src;
+			N dst;
+			std::coroutine_handle<> waiter{};
+			std::vector<N> nodes{};
+			std::vector<E> weights{};
+			bool connected = false;
+			std::exception_ptr error{};
+
+			auto resolve(graph<N, E> const& g) -> void {
+				try {
+					switch (kind) {
+					case query_kind::connections: nodes = g.connections(src); break;
+					case query_kind::weights: weights = g.weights(src, dst); break;
+					case query_kind::is_connected: connected = g.is_connected(src, dst); break;
+					}
+				} catch (...) {
+					error = std::current_exception();
+				}
+			}
+			auto copy_result(query const& other) -> void {
+				nodes = other.nodes;
+				weights = other.weights;
+				connected = other.connected;
+				error = other.error;
+			}
+		};
+
+		[[nodiscard]] static auto same_lookup(query const& x, query const& y) -> bool {
+			return x.kind == y.kind and x.src == y.src
+			       and (x.kind == query_kind::connections or x.dst == y.dst);
+		}
+
+		graph<N, E> const* graph_;
+		thread_pool* pool_;
+		std::vector<query*> pending_{};
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_ASYNC_QUERIES_HPP
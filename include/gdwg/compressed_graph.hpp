@@ -0,0 +1,342 @@
+#ifndef GDWG_COMPRESSED_GRAPH_HPP
+#define GDWG_COMPRESSED_GRAPH_HPP
+
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/memory.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	namespace detail {
+		// weights that compressed_graph keeps as varint coded deltas
+		template<typename E>
+		concept delta_codable =
+		   std::integral<E> and !std::same_as<E, bool> and sizeof(E) <= sizeof(std::uint64_t);
+
+		// LEB128: seven bits a byte, low bits first, the high bit set on every byte but the last
+		inline auto put_varint(std::vector<std::uint8_t>& bytes, std::uint64_t value) -> void {
+			while (value >= 0x80U) {
+				bytes.push_back(static_cast<std::uint8_t>(value | 0x80U));
+				value >>= 7U;
+			}
+			bytes.push_back(static_cast<std::uint8_t>(value));
+		}
+		[[nodiscard]] inline auto get_varint(std::uint8_t const*& pos) noexcept -> std::uint64_t {
+			auto value = std::uint64_t{0};
+			for (auto shift = 0U;; shift += 7U) {
+				auto const byte = *pos++;
+				value |= std::uint64_t{byte & 0x7FU} << shift;
+				if (byte < 0x80U) {
+					return value;
+				}
+			}
+		}
+
+		// the first weight of a run is zigzag coded, so small negative weights stay short too
+		template<delta_codable E>
+		[[nodiscard]] constexpr auto zigzag(E value) noexcept -> std::uint64_t {
+			auto const bits = static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<E>>(value));
+			if constexpr (std::is_signed_v<E>) {
+				return (bits << 1U) ^ (value < 0 ? ~std::uint64_t{0} : std::uint64_t{0});
+			}
+			else {
+				return bits;
+			}
+		}
+		template<delta_codable E>
+		[[nodiscard]] constexpr auto unzigzag(std::uint64_t bits) noexcept -> E {
+			if constexpr (std::is_signed_v<E>) {
+				bits = (bits >> 1U) ^ (std::uint64_t{0} - (bits & 1U));
+			}
+			return static_cast<E>(static_cast<std::make_unsigned_t<E>>(bits));
+		}
+
+		// the weights of one run, decoded as they are read: the first is zigzag coded and each
+		// after it is its (never negative) difference from the one before
+		template<typename E>
+		class delta_run {
+		public:
+			class iterator {
+			public:
+				using iterator_concept = std::forward_iterator_tag;
+				using iterator_category = std::input_iterator_tag;
+				using value_type = E;
+				using difference_type = std::ptrdiff_t;
+				using reference = E;
+
+				iterator() = default;
+
+				[[nodiscard]] auto operator*() const noexcept -> E {
+					return value_;
+				}
+				auto operator++() noexcept -> iterator& {
+					pos_ = next_;
+					if (pos_ != last_) {
+						using bits = std::make_unsigned_t<E>;
+						auto const delta = static_cast<bits>(get_varint(next_));
+						value_ = static_cast<E>(static_cast<bits>(static_cast<bits>(value_) + delta));
+					}
+					return *this;
+				}
+				auto operator++(int) noexcept -> iterator {
+					auto copy = *this;
+					++*this;
+					return copy;
+				}
+				[[nodiscard]] auto operator==(iterator const& other) const noexcept -> bool {
+					return pos_ == other.pos_;
+				}
+
+			private:
+				friend class delta_run;
+				iterator(std::uint8_t const* first, std::uint8_t const* last) noexcept
+				: pos_{first}
+				, next_{first}
+				, last_{last} {
+					if (pos_ != last_) {
+						value_ = unzigzag<E>(get_varint(next_));
+					}
+				}
+
+				std::uint8_t const* pos_ = nullptr; // the current weight's bytes
+				std::uint8_t const* next_ = nullptr; // the next weight's bytes
+				std::uint8_t const* last_ = nullptr;
+				E value_{};
+			};
+
+			delta_run() = default;
+			delta_run(std::uint8_t const* first, std::uint8_t const* last) noexcept
+			: first_{first}
+			, last_{last} {}
+
+			[[nodiscard]] auto begin() const noexcept -> iterator {
+				return iterator(first_, last_);
+			}
+			[[nodiscard]] auto end() const noexcept -> iterator {
+				return iterator(last_, last_);
+			}
+			[[nodiscard]] auto empty() const noexcept -> bool {
+				return first_ == last_;
+			}
+			// the number of weights, which is the number of bytes that end a varint: O(bytes)
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return static_cast<std::size_t>(
+				   std::count_if(first_, last_, [](std::uint8_t byte) { return byte < 0x80U; }));
+			}
+
+		private:
+			std::uint8_t const* first_ = nullptr;
+			std::uint8_t const* last_ = nullptr;
+		};
+	} // namespace detail
+
+	//   ======================
+	//   COMPRESSED GRAPH CLASS
+	//   ----------------------
+	//
+	// A read-only snapshot for multigraphs with many parallel edges, which keeps every distinct
+	// (src, dst) pair once and all the weights between them together in one run. Nodes are
+	// numbered as in the frozen_graph it is built from; the pairs of node i are
+	// targets()[offsets()[i] .. offsets()[i + 1]], sorted by dst id, and run(p) holds the weights
+	// of pair p in ascending order.
+	//
+	// Integral weights are delta coded: the first weight of a run and then each difference from
+	// the one before as a varint, so a run of 40 close weights takes about 40 bytes rather than
+	// 40 edges' worth of endpoints and tree slots. Other weights are kept as they are, still
+	// without repeating the endpoints. Either way run() and weights() are views over the run
+	// (forward ranges of E), decoded as they are read.
+	template<typename N, typename E>
+	class compressed_graph {
+	public:
+		static constexpr auto weights_are_delta_coded = detail::delta_codable<E>;
+		using weight_view = std::conditional_t<weights_are_delta_coded,
+		                                       detail::delta_run<E>,
+		                                       std::span<E const>>;
+
+		compressed_graph() = default;
+
+		// O(V + E log d) for out-degree d, to group each node's edges by dst and sort the weights
+		// of every run (a frozen graph from graph::freeze already has them so)
+		explicit compressed_graph(frozen_graph<N, E> const& g)
+		: nodes_{g.nodes()} {
+			offsets_.reserve(g.size() + 1);
+			auto row = std::vector<std::pair<node_id, E>>{};
+			for (auto from = node_id{0}; from < g.size(); ++from) {
+				auto const targets = g.out_edges(from);
+				auto const weights = g.out_weights(from);
+				row.clear();
+				for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+					row.emplace_back(targets[e], weights[e]);
+				}
+				if (!std::is_sorted(row.begin(), row.end())) {
+					std::sort(row.begin(), row.end());
+				}
+				for (auto first = row.begin(); first != row.end();) {
+					auto const last = std::find_if(first, row.end(), [to = first->first](auto const& e) {
+						return e.first != to;
+					});
+					targets_.push_back(first->first);
+					if constexpr (weights_are_delta_coded) {
+						using bits = std::make_unsigned_t<E>;
+						detail::put_varint(weights_, detail::zigzag(first->second));
+						for (auto e = first + 1; e != last; ++e) {
+							auto const delta = static_cast<bits>(static_cast<bits>(e->second)
+							                                     - static_cast<bits>((e - 1)->second));
+							detail::put_varint(weights_, delta);
+						}
+					}
+					else {
+						for (auto e = first; e != last; ++e) {
+							weights_.push_back(std::move(e->second));
+						}
+					}
+					runs_.push_back(weights_.size());
+					first = last;
+				}
+				offsets_.push_back(targets_.size());
+			}
+			edge_count_ = g.edge_count();
+			targets_.shrink_to_fit();
+			runs_.shrink_to_fit();
+			weights_.shrink_to_fit();
+			if (!std::is_sorted(nodes_.begin(), nodes_.end())) {
+				by_value_.resize(nodes_.size());
+				std::iota(by_value_.begin(), by_value_.end(), node_id{0});
+				std::sort(by_value_.begin(), by_value_.end(), [this](node_id a, node_id b) {
+					return nodes_[a] < nodes_[b];
+				});
+			}
+		}
+
+		// number of nodes
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return edge_count_;
+		}
+		// number of distinct (src, dst) pairs, which is the number of runs
+		[[nodiscard]] auto pair_count() const noexcept -> std::size_t {
+			return targets_.size();
+		}
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+
+		// value of node i
+		[[nodiscard]] auto node(node_id i) const -> N const& {
+			return nodes_[i];
+		}
+		// id of value n (binary search)
+		[[nodiscard]] auto id(N const& n) const -> node_id {
+			if (by_value_.empty()) {
+				auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), n);
+				if (it != nodes_.end() and *it == n) {
+					return static_cast<node_id>(it - nodes_.begin());
+				}
+			}
+			else {
+				auto const it = std::lower_bound(by_value_.begin(),
+				                                 by_value_.end(),
+				                                 n,
+				                                 [this](node_id i, N const& value) {
+					                                 return nodes_[i] < value;
+				                                 });
+				if (it != by_value_.end() and nodes_[*it] == n) {
+					return *it;
+				}
+			}
+			throw std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::id on a node that "
+			                         "doesn't exist in the graph");
+		}
+
+		// the distinct dsts of node i's edges, in ascending id order; the pair at
+		// out_pairs(i)[k] is number offsets()[i] + k
+		[[nodiscard]] auto out_pairs(node_id i) const noexcept -> std::span<node_id const> {
+			return {targets_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+		}
+		// the weights of pair p, in ascending order
+		[[nodiscard]] auto run(std::size_t p) const noexcept -> weight_view {
+			return {weights_.data() + runs_[p], weights_.data() + runs_[p + 1]};
+		}
+		// the weights of every edge from src to dst, in ascending order; empty if there are none.
+		// A binary search over src's pairs: O(log d).
+		[[nodiscard]] auto weights(node_id src, node_id dst) const noexcept -> weight_view {
+			auto const pairs = out_pairs(src);
+			auto const it = std::lower_bound(pairs.begin(), pairs.end(), dst);
+			if (it == pairs.end() or *it != dst) {
+				return {};
+			}
+			return run(offsets_[src] + static_cast<std::size_t>(it - pairs.begin()));
+		}
+		[[nodiscard]] auto is_connected(node_id src, node_id dst) const noexcept -> bool {
+			auto const pairs = out_pairs(src);
+			return std::binary_search(pairs.begin(), pairs.end(), dst);
+		}
+
+		// the underlying arrays (runs() has pair_count() + 1 entries, the start of each run in
+		// the weight storage and then its end)
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return nodes_;
+		}
+		[[nodiscard]] auto offsets() const noexcept -> std::vector<std::size_t> const& {
+			return offsets_;
+		}
+		[[nodiscard]] auto targets() const noexcept -> std::vector<node_id> const& {
+			return targets_;
+		}
+		[[nodiscard]] auto runs() const noexcept -> std::vector<std::size_t> const& {
+			return runs_;
+		}
+
+		// what the snapshot costs, in the categories of graph::memory_usage: the pairs and their
+		// weights count as edges, and the offsets into them as index
+		[[nodiscard]] auto memory_usage() const -> memory_footprint {
+			auto usage = memory_footprint{};
+			usage.nodes = nodes_.capacity() * sizeof(N);
+			usage.edges = targets_.capacity() * sizeof(node_id)
+			              + weights_.capacity() * sizeof(typename decltype(weights_)::value_type);
+			usage.index = (offsets_.capacity() + runs_.capacity()) * sizeof(std::size_t)
+			              + by_value_.capacity() * sizeof(node_id);
+			if constexpr (!std::is_trivially_copyable_v<N>) {
+				for (auto const& n : nodes_) {
+					usage.payload += heap_bytes<N>::of(n);
+				}
+			}
+			if constexpr (!weights_are_delta_coded and !std::is_trivially_copyable_v<E>) {
+				for (auto const& w : weights_) {
+					usage.payload += heap_bytes<E>::of(w);
+				}
+			}
+			return usage;
+		}
+
+		[[nodiscard]] auto operator==(compressed_graph const& other) const -> bool = default;
+
+	private:
+		std::vector<N> nodes_{};
+		std::vector<std::size_t> offsets_{0};
+		std::vector<node_id> targets_{};
+		std::vector<std::size_t> runs_{0};
+		// the runs one after another: varint bytes, or the weights themselves
+		std::conditional_t<weights_are_delta_coded, std::vector<std::uint8_t>, std::vector<E>>
+		   weights_{};
+		std::size_t edge_count_ = 0;
+		// ids in the order of their values; empty while the nodes are sorted
+		std::vector<node_id> by_value_{};
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_COMPRESSED_GRAPH_HPP
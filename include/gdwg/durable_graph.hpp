@@ -0,0 +1,327 @@
+#ifndef GDWG_DURABLE_GRAPH_HPP
+#define GDWG_DURABLE_GRAPH_HPP
+
+#include "gdwg/graph.hpp"
+#include "gdwg/serializer.hpp"
+#include "gdwg/wal.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace gdwg {
+
+	//   ====================
+	//   DURABLE GRAPH CLASS
+	//   --------------------
+	//
+	// A graph kept in a directory as a snapshot plus a write-ahead log of the modifications made
+	// since. Each modifier is applied to the in-memory graph first; if it throws, or returns false
+	// because nothing changed, nothing is logged. Otherwise one record is appended to the log,
+	// and it is on disk once commit() returns (or, without a commit, within the log's group
+	// delay).
+	//
+	// Opening a directory loads the snapshot and replays only the records written after it, so
+	// restarting costs the snapshot load plus the log tail. compact() writes a fresh snapshot and
+	// empties the log. The topological order of the graph isn't stored.
+	//
+	// Files in dir: "snapshot" (magic "gdwgsnap", then the lsn it includes, the nodes, the edges
+	// and a CRC-32 of all of that) and "wal" (see write_ahead_log).
+	template<typename N, typename E>
+	class durable_graph {
+	public:
+		// opens the graph stored in dir, creating dir and an empty graph if they don't exist
+		explicit durable_graph(std::filesystem::path const& dir, wal_options const& opts = {})
+		: durable_graph(recover(dir), dir, opts) {}
+
+		[[nodiscard]] auto get() const noexcept -> graph<N, E> const& {
+			return graph_;
+		}
+
+		// =========
+		// MODIFIERS
+		// ---------
+		auto insert_node(N const& value) -> bool {
+			return graph_.insert_node(value) and log(op::insert_node, value);
+		}
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return graph_.insert_edge(src, dst, weight) and log(op::insert_edge, src, dst, weight);
+		}
+		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			return graph_.replace_node(old_data, new_data)
+			       and log(op::replace_node, old_data, new_data);
+		}
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			graph_.merge_replace_node(old_data, new_data);
+			log(op::merge_replace_node, old_data, new_data);
+		}
+		auto erase_node(N const& value) -> bool {
+			return graph_.erase_node(value) and log(op::erase_node, value);
+		}
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return graph_.erase_edge(src, dst, weight) and log(op::erase_edge, src, dst, weight);
+		}
+		auto clear() -> void {
+			graph_.clear();
+			log(op::clear);
+		}
+
+		// ===========
+		// PERSISTENCE
+		// -----------
+
+		// blocks until every modification so far is on disk
+		auto commit() -> void {
+			log_.commit();
+		}
+
+		// replaces the snapshot with the current graph and empties the log. A crash part way
+		// through loses nothing: the old snapshot is only replaced once the new one is complete,
+		// and records the new snapshot already includes are skipped on replay.
+		auto compact() -> void {
+			log_.commit();
+			write_snapshot(dir_, graph_, log_.last_lsn());
+			log_.reset();
+		}
+
+		// lsn of the last modification (0 for none since the directory was created)
+		[[nodiscard]] auto lsn() const -> std::uint64_t {
+			return log_.last_lsn();
+		}
+
+	private:
+		enum class op : std::uint8_t {
+			insert_node = 1,
+			insert_edge,
+			replace_node,
+			merge_replace_node,
+			erase_node,
+			erase_edge,
+			clear,
+		};
+
+		struct recovered {
+			graph<N, E> g;
+			std::uint64_t lsn = 0;
+		};
+
+		static constexpr auto magic = std::string_view("gdwgsnap");
+
+		durable_graph(recovered r, std::filesystem::path const& dir, wal_options const& opts)
+		: graph_{std::move(r.g)}
+		, dir_{dir}
+		, log_{dir / "wal", r.lsn + 1, opts} {}
+
+		template<typename... Ts>
+		auto log(op type, Ts const&... values) -> bool {
+			auto payload = std::string{};
+			(serializer<Ts>::write(payload, values), ...);
+			log_.append(static_cast<std::uint8_t>(type), payload);
+			return true;
+		}
+
+		[[noreturn]] static auto corrupt(std::filesystem::path const& dir) -> void {
+			throw std::runtime_error("Cannot open gdwg::durable_graph<N, E> in " + dir.string()
+			                         + ": the snapshot or log is corrupt");
+		}
+
+		static auto recover(std::filesystem::path const& dir) -> recovered {
+			std::filesystem::create_directories(dir);
+			auto r = load_snapshot(dir);
+			write_ahead_log::replay(dir / "wal", [&](wal_record const& record) {
+				if (record.lsn <= r.lsn) {
+					return; // already in the snapshot
+				}
+				if (!apply(r.g, record)) {
+					corrupt(dir);
+				}
+				r.lsn = record.lsn;
+			});
+			return r;
+		}
+
+		// reads exactly the given values from a record's payload
+		template<typename... Ts>
+		static auto decode(std::string_view in, Ts&... values) -> bool {
+			return (serializer<Ts>::read(in, values) and ...) and in.empty();
+		}
+
+		// redoes one logged modification; false if the record can't be decoded
+		static auto apply(graph<N, E>& g, wal_record const& record) -> bool {
+			auto a = N{};
+			auto b = N{};
+			auto w = E{};
+			switch (static_cast<op>(record.type)) {
+			case op::insert_node:
+				if (!decode(record.payload, a)) {
+					return false;
+				}
+				g.insert_node(a);
+				return true;
+			case op::insert_edge:
+				if (!decode(record.payload, a, b, w)) {
+					return false;
+				}
+				g.insert_edge(a, b, w);
+				return true;
+			case op::replace_node:
+				if (!decode(record.payload, a, b)) {
+					return false;
+				}
+				g.replace_node(a, b);
+				return true;
+			case op::merge_replace_node:
+				if (!decode(record.payload, a, b)) {
+					return false;
+				}
+				g.merge_replace_node(a, b);
+				return true;
+			case op::erase_node:
+				if (!decode(record.payload, a)) {
+					return false;
+				}
+				g.erase_node(a);
+				return true;
+			case op::erase_edge:
+				if (!decode(record.payload, a, b, w)) {
+					return false;
+				}
+				g.erase_edge(a, b, w);
+				return true;
+			case op::clear:
+				if (!decode(record.payload)) {
+					return false;
+				}
+				g.clear();
+				return true;
+			}
+			return false;
+		}
+
+		static auto load_snapshot(std::filesystem::path const& dir) -> recovered {
+			auto in = std::ifstream(dir / "snapshot", std::ios::binary);
+			if (!in) {
+				return {};
+			}
+			auto const data = std::string(std::istreambuf_iterator<char>(in), {});
+			auto body = std::string_view(data);
+			auto crc = std::uint32_t{0};
+			if (!body.starts_with(magic) or body.size() < magic.size() + sizeof(crc)) {
+				corrupt(dir);
+			}
+			body = body.substr(magic.size(), body.size() - magic.size() - sizeof(crc));
+			std::memcpy(&crc, data.data() + data.size() - sizeof(crc), sizeof(crc));
+			if (detail::crc32(body) != crc) {
+				corrupt(dir);
+			}
+
+			auto r = recovered{};
+			auto count = std::uint64_t{0};
+			auto nodes = std::vector<N>{};
+			if (!serializer<std::uint64_t>::read(body, r.lsn)
+			    or !serializer<std::uint64_t>::read(body, count))
+			{
+				corrupt(dir);
+			}
+			nodes.resize(count);
+			for (auto& n : nodes) {
+				if (!serializer<N>::read(body, n)) {
+					corrupt(dir);
+				}
+			}
+			auto edges = std::vector<typename graph<N, E>::value_type>{};
+			if (!serializer<std::uint64_t>::read(body, count)) {
+				corrupt(dir);
+			}
+			edges.resize(count);
+			for (auto& e : edges) {
+				if (!serializer<N>::read(body, e.from) or !serializer<N>::read(body, e.to)
+				    or !serializer<E>::read(body, e.weight))
+				{
+					corrupt(dir);
+				}
+			}
+			if (!body.empty()) {
+				corrupt(dir);
+			}
+			r.g = graph<N, E>(edges.begin(), edges.end());
+			for (auto const& n : nodes) {
+				r.g.insert_node(n); // the ones without edges
+			}
+			return r;
+		}
+
+		// writes the snapshot to a temporary file a megabyte at a time, syncs it, and only then
+		// renames it over the old one
+		static auto write_snapshot(std::filesystem::path const& dir,
+		                           graph<N, E> const& g,
+		                           std::uint64_t lsn) -> void {
+			auto const temporary = dir / "snapshot.tmp";
+			auto const fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0) {
+				detail::throw_errno("Cannot write the snapshot " + temporary.string());
+			}
+			auto crc = std::uint32_t{0};
+			auto buffer = std::string{};
+			auto flush = [&](std::size_t at_least) {
+				if (buffer.size() >= at_least) {
+					crc = detail::crc32(buffer, crc);
+					detail::write_all(fd, buffer);
+					buffer.clear();
+				}
+			};
+			try {
+				constexpr auto chunk = std::size_t{1} << 20U;
+				detail::write_all(fd, magic);
+				auto const nodes = g.nodes();
+				serializer<std::uint64_t>::write(buffer, lsn);
+				serializer<std::uint64_t>::write(buffer, nodes.size());
+				for (auto const& n : nodes) {
+					serializer<N>::write(buffer, n);
+					flush(chunk);
+				}
+				auto edges = std::uint64_t{0};
+				for (auto it = g.begin(); it != g.end(); ++it) {
+					++edges;
+				}
+				serializer<std::uint64_t>::write(buffer, edges);
+				for (auto const& [from, to, weight] : g) {
+					serializer<N>::write(buffer, from);
+					serializer<N>::write(buffer, to);
+					serializer<E>::write(buffer, weight);
+					flush(chunk);
+				}
+				flush(0);
+				serializer<std::uint32_t>::write(buffer, crc);
+				detail::write_all(fd, buffer);
+				if (::fsync(fd) != 0) {
+					detail::throw_errno("Cannot sync the snapshot " + temporary.string());
+				}
+			} catch (...) {
+				::close(fd);
+				throw;
+			}
+			::close(fd);
+			std::filesystem::rename(temporary, dir / "snapshot");
+			detail::sync_directory(dir);
+		}
+
+		graph<N, E> graph_;
+		std::filesystem::path dir_;
+		write_ahead_log log_;
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_DURABLE_GRAPH_HPP
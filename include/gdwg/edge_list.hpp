@@ -0,0 +1,260 @@
+#ifndef GDWG_EDGE_LIST_HPP
+#define GDWG_EDGE_LIST_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	struct edge_list_options {
+		// the character between the from, to and weight fields, for example ',' for CSV or '\t'
+		// for TSV ('\0' splits on any run of spaces and tabs). Fields are trimmed of spaces and
+		// tabs either way.
+		char delimiter = '\0';
+		// lines whose first non-blank character is this are skipped, as are blank lines
+		char comment = '#';
+		bool skip_header = false;
+		// bytes read from the stream at a time; lines longer than this still work, the buffer
+		// grows to fit them
+		std::size_t chunk_size = std::size_t{1} << 22U;
+	};
+
+	namespace detail {
+		// parses one field: a char is the one character of the field, other arithmetic types use
+		// std::from_chars (which needs the whole field to be a number), and anything else is
+		// constructed from the characters
+		template<typename T>
+		[[nodiscard]] auto parse_field(std::string_view text, T& value) -> bool {
+			if constexpr (std::is_same_v<T, char>) {
+				value = text.front();
+				return text.size() == 1;
+			}
+			else if constexpr (std::is_arithmetic_v<T>) {
+				auto const* const last = text.data() + text.size();
+				auto const [ptr, ec] = std::from_chars(text.data(), last, value);
+				return ec == std::errc{} and ptr == last;
+			}
+			else {
+				static_assert(std::is_constructible_v<T, std::string_view>,
+				              "edge list nodes and weights must be arithmetic or constructible from a "
+				              "std::string_view");
+				value = T(text);
+				return true;
+			}
+		}
+
+		[[nodiscard]] inline auto is_blank(char c) noexcept -> bool {
+			return c == ' ' or c == '\t' or c == '\r';
+		}
+
+		[[nodiscard]] inline auto trim(std::string_view text) noexcept -> std::string_view {
+			while (!text.empty() and is_blank(text.front())) {
+				text.remove_prefix(1);
+			}
+			while (!text.empty() and is_blank(text.back())) {
+				text.remove_suffix(1);
+			}
+			return text;
+		}
+
+		// the next field of line, which is removed from the front of it
+		[[nodiscard]] inline auto next_field(std::string_view& line, char delimiter) noexcept
+		   -> std::string_view {
+			line = trim(line);
+			auto const end = delimiter == '\0'
+			                    ? std::find_if(line.begin(), line.end(), is_blank)
+			                    : std::find(line.begin(), line.end(), delimiter);
+			auto const length = static_cast<std::size_t>(end - line.begin());
+			auto const field = trim(line.substr(0, length));
+			line.remove_prefix(std::min(line.size(), length + (end != line.end() ? 1 : 0)));
+			return field;
+		}
+
+		// a bounded single producer, single consumer queue of parsed batches; close() ends it
+		// from either side
+		template<typename T>
+		class batch_queue {
+		public:
+			explicit batch_queue(std::size_t capacity)
+			: capacity_{capacity} {}
+
+			// false if the queue was closed by the consumer
+			auto push(std::vector<T> batch) -> bool {
+				auto lock = std::unique_lock(mutex_);
+				not_full_.wait(lock, [this] { return closed_ or batches_.size() < capacity_; });
+				if (closed_) {
+					return false;
+				}
+				batches_.push_back(std::move(batch));
+				not_empty_.notify_one();
+				return true;
+			}
+			// false once the queue is closed and empty
+			auto pop(std::vector<T>& batch) -> bool {
+				auto lock = std::unique_lock(mutex_);
+				not_empty_.wait(lock, [this] { return closed_ or !batches_.empty(); });
+				if (batches_.empty()) {
+					return false;
+				}
+				batch = std::move(batches_.front());
+				batches_.pop_front();
+				not_full_.notify_one();
+				return true;
+			}
+			auto close() -> void {
+				auto const lock = std::scoped_lock(mutex_);
+				closed_ = true;
+				not_full_.notify_all();
+				not_empty_.notify_all();
+			}
+
+		private:
+			std::size_t capacity_;
+			std::deque<std::vector<T>> batches_{};
+			bool closed_ = false;
+			std::mutex mutex_{};
+			std::condition_variable not_full_{};
+			std::condition_variable not_empty_{};
+		};
+	} // namespace detail
+
+	// ===========================
+	// STREAMING EDGE LIST INPUT
+	// ---------------------------
+
+	// Reads "from to weight" lines from in and inserts them into g, adding nodes as they are first
+	// seen. The stream is read chunk_size bytes at a time and each chunk is parsed on the calling
+	// thread while a second thread inserts the previous one, so at most a few chunks of parsed
+	// edges are held on top of the graph itself. Throws a runtime_error naming the line if a line
+	// doesn't have three fields that parse, by which time g may already hold some of the edges
+	// before it.
+	// Returns the number of edges read (duplicates included).
+	template<typename N, typename E>
+	auto read_edge_list(std::istream& in, graph<N, E>& g, edge_list_options const& opts = {})
+	   -> std::size_t {
+		using value_type = typename graph<N, E>::value_type;
+		auto queue = detail::batch_queue<value_type>(2);
+		auto insert_error = std::exception_ptr{};
+		auto inserter = std::thread([&] {
+			auto batch = std::vector<value_type>{};
+			try {
+				while (queue.pop(batch)) {
+					for (auto const& e : batch) {
+						g.insert_node(e.from);
+						g.insert_node(e.to);
+						g.insert_edge(e.from, e.to, e.weight);
+					}
+				}
+			} catch (...) {
+				insert_error = std::current_exception();
+				queue.close();
+			}
+		});
+
+		auto edges = std::size_t{0};
+		auto parse_error = std::exception_ptr{};
+		try {
+			auto line_number = std::size_t{0};
+			auto skip_header = opts.skip_header;
+			auto buffer = std::string(std::max(opts.chunk_size, std::size_t{1}), '\0');
+			auto kept = std::size_t{0}; // bytes of an unfinished line carried over from the last read
+			auto at_end = false;
+			while (!at_end) {
+				if (kept == buffer.size()) {
+					buffer.resize(buffer.size() * 2); // one line is longer than a chunk
+				}
+				auto const read = in.rdbuf()->sgetn(buffer.data() + kept,
+				                                    static_cast<std::streamsize>(buffer.size() - kept));
+				at_end = read <= 0;
+				auto const filled = kept + static_cast<std::size_t>(std::max(read, std::streamsize{0}));
+				auto text = std::string_view(buffer.data(), filled);
+				auto complete = at_end ? text.size() : text.rfind('\n') + 1; // npos + 1 == 0
+				auto batch = std::vector<value_type>{};
+				for (auto pos = std::size_t{0}; pos < complete;) {
+					auto const newline = std::min(text.find('\n', pos), complete);
+					auto line = text.substr(pos, newline - pos);
+					pos = newline + 1;
+					++line_number;
+					auto const trimmed = detail::trim(line);
+					if (trimmed.empty() or trimmed.front() == opts.comment) {
+						continue;
+					}
+					if (std::exchange(skip_header, false)) {
+						continue;
+					}
+					auto e = value_type{};
+					auto const from = detail::next_field(line, opts.delimiter);
+					auto const to = detail::next_field(line, opts.delimiter);
+					auto const weight = detail::next_field(line, opts.delimiter);
+					if (from.empty() or to.empty() or weight.empty() or !detail::trim(line).empty()
+					    or !detail::parse_field(from, e.from) or !detail::parse_field(to, e.to)
+					    or !detail::parse_field(weight, e.weight))
+					{
+						throw std::runtime_error("Cannot read the edge list: line "
+						                         + std::to_string(line_number)
+						                         + " is not a valid \"from to weight\" edge");
+					}
+					batch.push_back(std::move(e));
+				}
+				kept = filled - complete;
+				std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(complete),
+				          buffer.begin() + static_cast<std::ptrdiff_t>(filled),
+				          buffer.begin());
+				edges += batch.size();
+				// sorted batches insert faster: neighbouring edges share the same part of the sets
+				std::sort(batch.begin(), batch.end(), [](value_type const& x, value_type const& y) {
+					return std::tie(x.from, x.to, x.weight) < std::tie(y.from, y.to, y.weight);
+				});
+				if (!batch.empty() and !queue.push(std::move(batch))) {
+					break; // the inserter failed
+				}
+			}
+		} catch (...) {
+			parse_error = std::current_exception();
+		}
+		queue.close();
+		inserter.join();
+		if (insert_error) {
+			std::rethrow_exception(insert_error);
+		}
+		if (parse_error) {
+			std::rethrow_exception(parse_error);
+		}
+		return edges;
+	}
+
+	// a new graph with the edges of the file at path (see read_edge_list)
+	template<typename N, typename E>
+	[[nodiscard]] auto load_edge_list(std::filesystem::path const& path,
+	                                  edge_list_options const& opts = {}) -> graph<N, E> {
+		auto in = std::ifstream(path, std::ios::binary);
+		if (!in) {
+			throw std::runtime_error("Cannot open the edge list " + path.string());
+		}
+		auto g = graph<N, E>{};
+		read_edge_list(in, g, opts);
+		return g;
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_EDGE_LIST_HPP
@@ -0,0 +1,207 @@
+#ifndef GDWG_FROZEN_GRAPH_HPP
+#define GDWG_FROZEN_GRAPH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// dense id of a node in a frozen_graph: its position in node order, which is the sorted
+	// order unless the frozen graph was permuted
+	using node_id = std::uint32_t;
+
+	//   ==================
+	//   FROZEN GRAPH CLASS
+	//   ------------------
+	//
+	// A read-only snapshot of a graph in compressed sparse row form, for algorithms that walk the
+	// whole graph. Nodes are numbered 0..size()-1 in the graph's node order, and the outgoing edges
+	// of node i are targets()[offsets()[i] .. offsets()[i + 1]] with the matching weights(), in the
+	// graph's edge order (by dst, then weight). Build one with graph::freeze().
+	//
+	// permute() renumbers the nodes, for locality (see algorithms/reorder.hpp). Node values keep
+	// their meaning: node(i) and id(n) still map between the two, and edges stay sorted by dst id,
+	// then weight, within each node.
+	template<typename N, typename E>
+	class frozen_graph {
+	public:
+		frozen_graph() = default;
+
+		// takes ownership of already built arrays: nodes unique, offsets.size() == nodes.size() + 1,
+		// and targets/weights of length offsets.back(). Nodes that aren't sorted get an index for
+		// id() to search.
+		frozen_graph(std::vector<N> nodes,
+		             std::vector<std::size_t> offsets,
+		             std::vector<node_id> targets,
+		             std::vector<E> weights)
+		: nodes_{std::move(nodes)}
+		, offsets_{std::move(offsets)}
+		, targets_{std::move(targets)}
+		, weights_{std::move(weights)} {
+			if (offsets_.empty()) {
+				offsets_.push_back(0);
+			}
+			if (offsets_.size() != nodes_.size() + 1 or offsets_.back() != targets_.size()
+			    or targets_.size() != weights_.size())
+			{
+				throw std::invalid_argument("Cannot build gdwg::frozen_graph<N, E> from arrays of "
+				                            "mismatched sizes");
+			}
+			if (!std::is_sorted(nodes_.begin(), nodes_.end())) {
+				by_value_.resize(nodes_.size());
+				std::iota(by_value_.begin(), by_value_.end(), node_id{0});
+				std::sort(by_value_.begin(), by_value_.end(), [this](node_id a, node_id b) {
+					return nodes_[a] < nodes_[b];
+				});
+			}
+		}
+
+		// number of nodes
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return targets_.size();
+		}
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+
+		// value of node i
+		[[nodiscard]] auto node(node_id i) const -> N const& {
+			return nodes_[i];
+		}
+		// id of value n (binary search)
+		[[nodiscard]] auto id(N const& n) const -> node_id {
+			if (by_value_.empty()) {
+				auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), n);
+				if (it != nodes_.end() and *it == n) {
+					return static_cast<node_id>(it - nodes_.begin());
+				}
+			}
+			else {
+				auto const it = std::lower_bound(by_value_.begin(),
+				                                 by_value_.end(),
+				                                 n,
+				                                 [this](node_id i, N const& value) {
+					                                 return nodes_[i] < value;
+				                                 });
+				if (it != by_value_.end() and nodes_[*it] == n) {
+					return *it;
+				}
+			}
+			throw std::runtime_error("Cannot call gdwg::frozen_graph<N, E>::id on a node that "
+			                         "doesn't exist in the graph");
+		}
+
+		// dsts and weights of the edges leaving node i
+		[[nodiscard]] auto out_edges(node_id i) const noexcept -> std::span<node_id const> {
+			return {targets_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+		}
+		[[nodiscard]] auto out_weights(node_id i) const noexcept -> std::span<E const> {
+			return {weights_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]};
+		}
+		[[nodiscard]] auto out_degree(node_id i) const noexcept -> std::size_t {
+			return offsets_[i + 1] - offsets_[i];
+		}
+
+		// the underlying arrays
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const& {
+			return nodes_;
+		}
+		[[nodiscard]] auto offsets() const noexcept -> std::vector<std::size_t> const& {
+			return offsets_;
+		}
+		[[nodiscard]] auto targets() const noexcept -> std::vector<node_id> const& {
+			return targets_;
+		}
+		[[nodiscard]] auto weights() const noexcept -> std::vector<E> const& {
+			return weights_;
+		}
+
+		// the same nodes with every edge reversed (incoming edges in CSR form), built with a
+		// counting sort in O(V + E)
+		[[nodiscard]] auto transpose() const -> frozen_graph {
+			auto offsets = std::vector<std::size_t>(size() + 1, 0);
+			for (auto const t : targets_) {
+				++offsets[t + 1];
+			}
+			for (auto i = std::size_t{0}; i < size(); ++i) {
+				offsets[i + 1] += offsets[i];
+			}
+			auto next = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			auto targets = std::vector<node_id>(edge_count());
+			auto weights = std::vector<E>(edge_count());
+			for (auto from = node_id{0}; from < size(); ++from) {
+				for (auto e = offsets_[from]; e != offsets_[from + 1]; ++e) {
+					auto const slot = next[targets_[e]]++;
+					targets[slot] = from;
+					weights[slot] = weights_[e];
+				}
+			}
+			return frozen_graph(nodes_, std::move(offsets), std::move(targets), std::move(weights));
+		}
+
+		// the same graph with node order[i] renumbered i; order must be a permutation of the ids.
+		// O(V + E log d) for out-degree d, to keep each node's edges sorted by their new dst ids.
+		[[nodiscard]] auto permute(std::span<node_id const> order) const -> frozen_graph {
+			auto renumbered = std::vector<node_id>(size(), static_cast<node_id>(size()));
+			if (order.size() != size()) {
+				throw std::invalid_argument("Cannot call gdwg::frozen_graph<N, E>::permute with an "
+				                            "order that isn't a permutation of the nodes");
+			}
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				if (order[i] >= size() or renumbered[order[i]] != size()) {
+					throw std::invalid_argument("Cannot call gdwg::frozen_graph<N, E>::permute with an "
+					                            "order that isn't a permutation of the nodes");
+				}
+				renumbered[order[i]] = static_cast<node_id>(i);
+			}
+			auto nodes = std::vector<N>{};
+			nodes.reserve(size());
+			auto offsets = std::vector<std::size_t>{0};
+			offsets.reserve(size() + 1);
+			auto targets = std::vector<node_id>{};
+			targets.reserve(edge_count());
+			auto weights = std::vector<E>{};
+			weights.reserve(edge_count());
+			auto row = std::vector<std::pair<node_id, E>>{};
+			for (auto const old : order) {
+				nodes.push_back(nodes_[old]);
+				row.clear();
+				for (auto e = offsets_[old]; e != offsets_[old + 1]; ++e) {
+					row.emplace_back(renumbered[targets_[e]], weights_[e]);
+				}
+				std::sort(row.begin(), row.end());
+				for (auto& [to, weight] : row) {
+					targets.push_back(to);
+					weights.push_back(std::move(weight));
+				}
+				offsets.push_back(targets.size());
+			}
+			return frozen_graph(std::move(nodes),
+			                    std::move(offsets),
+			                    std::move(targets),
+			                    std::move(weights));
+		}
+
+		[[nodiscard]] auto operator==(frozen_graph const& other) const -> bool = default;
+
+	private:
+		std::vector<N> nodes_{};
+		std::vector<std::size_t> offsets_{0};
+		std::vector<node_id> targets_{};
+		std::vector<E> weights_{};
+		// ids in the order of their values; empty while the nodes are sorted
+		std::vector<node_id> by_value_{};
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_FROZEN_GRAPH_HPP
@@ -1,27 +1,164 @@
 #ifndef GDWG_GRAPH_HPP
 #define GDWG_GRAPH_HPP
 
-#include <__functional_base>
-#include <__tuple>
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/memory.hpp"
+#include "gdwg/query_cache.hpp"
+#include "gdwg/stats.hpp"
+#include "gdwg/thread_pool.hpp"
+
 #include <algorithm>
+#include <array>
 #include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <fmt/ostream.h>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <ostream>
-#include <pthread.h>
 #include <range/v3/algorithm.hpp>
 #include <range/v3/iterator.hpp>
 #include <range/v3/utility.hpp>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace gdwg {
+	namespace detail {
+		// below this many elements the cost of handing work to the pool outweighs the speed-up
+		inline constexpr auto parallel_threshold = std::size_t{1} << 14;
+
+		// number of contiguous blocks [0, n) is split into by parallel_blocks
+		[[nodiscard]] inline auto block_count(std::size_t n) noexcept -> std::size_t {
+			if (n < 2 * parallel_threshold) {
+				return 1;
+			}
+			return std::min(n / parallel_threshold, thread_pool::shared().size());
+		}
+
+		// calls f(block, first, last) for each of the block_count(n) blocks of [0, n) on the shared
+		// thread pool. The first exception thrown by any block is rethrown once all blocks finish.
+		template<typename F>
+		auto parallel_blocks(std::size_t n, F f) -> void {
+			auto const blocks = block_count(n);
+			if (blocks == 1) {
+				f(std::size_t{0}, std::size_t{0}, n);
+				return;
+			}
+			thread_pool::shared().parallel_for(
+			   blocks,
+			   [&](std::size_t block, std::size_t last) {
+				   for (; block != last; ++block) {
+					   f(block, n * block / blocks, n * (block + 1) / blocks);
+				   }
+			   },
+			   1);
+		}
+
+		// sorts each block, then merges neighbouring runs pairwise (in parallel) until one sorted
+		// run is left
+		template<typename T, typename Compare>
+		auto parallel_sort(std::vector<T>& v, Compare comp) -> void {
+			auto const n = v.size();
+			auto const blocks = block_count(n);
+			parallel_blocks(n, [&](std::size_t, std::size_t first, std::size_t last) {
+				std::sort(v.begin() + static_cast<std::ptrdiff_t>(first),
+				          v.begin() + static_cast<std::ptrdiff_t>(last),
+				          comp);
+			});
+			auto bound = [&](std::size_t block) {
+				return v.begin() + static_cast<std::ptrdiff_t>(n * std::min(block, blocks) / blocks);
+			};
+			for (auto width = std::size_t{1}; width < blocks; width *= 2) {
+				auto const merges = (blocks - width + 2 * width - 1) / (2 * width);
+				thread_pool::shared().parallel_for(
+				   merges,
+				   [&](std::size_t merge, std::size_t last) {
+					   for (; merge != last; ++merge) {
+						   auto const block = merge * 2 * width;
+						   std::inplace_merge(bound(block),
+						                      bound(block + width),
+						                      bound(block + 2 * width),
+						                      comp);
+					   }
+				   },
+				   1);
+			}
+		}
+
+		// a hint to start loading the cache line at p; it never faults, so any address will do
+		inline auto prefetch(void const* p) noexcept -> void {
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(p);
+#else
+			static_cast<void>(p);
+#endif
+		}
+
+		// what a node keeps of its value to order it without reading the value itself: nothing,
+		// for most types (compare() is always a tie)
+		template<typename N>
+		struct key_prefix {
+			constexpr key_prefix() noexcept = default;
+			constexpr explicit key_prefix(N const&) noexcept {}
+			[[nodiscard]] constexpr auto compare(key_prefix) const noexcept -> int {
+				return 0;
+			}
+		};
+
+		// for strings, the first eight bytes, big-endian and zero padded, so that comparing two
+		// prefixes as integers orders them as the strings are ordered. Prefixes that differ decide
+		// the order; a tie (a shared first eight bytes, or padding against '\0') decides nothing.
+		template<>
+		struct key_prefix<std::string> {
+			key_prefix() noexcept = default;
+			explicit key_prefix(std::string const& value) noexcept {
+				auto bytes = std::array<unsigned char, sizeof(bits)>{};
+				if (value.size() >= bytes.size()) {
+					std::memcpy(bytes.data(), value.data(), bytes.size()); // one load
+				}
+				else {
+					std::memcpy(bytes.data(), value.data(), value.size());
+				}
+				for (auto const b : bytes) {
+					bits = bits << 8U | b; // a byte swap
+				}
+			}
+			[[nodiscard]] auto compare(key_prefix other) const noexcept -> int {
+				return bits < other.bits ? -1 : (other.bits < bits ? 1 : 0);
+			}
+			std::uint64_t bits = 0;
+		};
+	} // namespace detail
+
+	// what a graph::change records
+	enum class change_kind {
+		node_added, // from
+		node_renamed, // from was replaced by to, keeping its edges (replace_node)
+		node_merged, // from was merged into to: its edges now use to, duplicates dropped
+		node_erased, // from, and every edge touching it
+		edge_added, // from, to, weight
+		edge_erased, // from, to, weight
+		cleared, // every node and edge
+	};
+
+	// node and weight types small enough, and trivially copyable, to be copied into every edge
+	// (see graph::stores_edges_inline)
+	template<typename T>
+	concept inline_storable = std::is_trivially_copyable_v<T> and sizeof(T) <= 2 * sizeof(void*);
 
 	template<concepts::regular N, concepts::regular E>
 	requires concepts::totally_ordered<N> //
@@ -39,6 +176,43 @@ namespace gdwg {
 			}
 		};
 
+		// one modification, as recorded by the change stream. Fields a kind doesn't use (see
+		// change_kind) are left value-initialised.
+		struct change {
+			std::uint64_t sequence = 0;
+			change_kind kind = change_kind::cleared;
+			N from{};
+			N to{};
+			E weight{};
+			[[nodiscard]] auto operator==(change const& other) const -> bool = default;
+		};
+
+		// the changes from some sequence number on, and the sequence number to ask for next
+		struct change_batch {
+			std::vector<change> changes{};
+			std::uint64_t next = 0;
+		};
+
+		// the node and edge insertions and removals that turn one graph into another (see diff).
+		// Every list is sorted, and erased_edges leaves out the edges that go with an erased node.
+		struct patch {
+			std::vector<N> erased_nodes{};
+			std::vector<value_type> erased_edges{};
+			std::vector<N> added_nodes{};
+			std::vector<value_type> added_edges{};
+			[[nodiscard]] auto empty() const noexcept -> bool {
+				return erased_nodes.empty() and erased_edges.empty() and added_nodes.empty()
+				       and added_edges.empty();
+			}
+			[[nodiscard]] auto operator==(patch const& other) const -> bool = default;
+		};
+
+		// With inline_storable N and E, each edge is kept by value in the edge set, holding copies
+		// of its src and dst values, rather than as a shared edge that reads them from the nodes.
+		// Edge comparisons then touch no other memory, and an edge costs one tree node instead of
+		// a tree node, a control block and an edge object. The public interface is the same.
+		static constexpr auto stores_edges_inline = inline_storable<N> and inline_storable<E>;
+
 		class iterator; // forward declaration of iterator class
 
 		//   =============
@@ -56,18 +230,34 @@ namespace gdwg {
 			}
 			explicit node(N const& val) {
 				node_value_ = val;
+				prefix_ = detail::key_prefix<N>(val);
+				detail::count(detail::counter::node_value_copies);
 			}
 			// node setters
 			void set_node_value(N const& val) {
 				node_value_ = val;
+				prefix_ = detail::key_prefix<N>(val);
+				detail::count(detail::counter::node_value_copies);
+			}
+			// position in the topological order, when one is maintained
+			void set_order(std::size_t order) {
+				order_ = order;
 			}
 			// node getters
-			[[nodiscard]] auto get_node_value() const -> N {
+			[[nodiscard]] auto get_node_value() const -> N const& {
 				return node_value_;
 			}
+			[[nodiscard]] auto get_order() const -> std::size_t {
+				return order_;
+			}
+			[[nodiscard]] auto get_prefix() const -> detail::key_prefix<N> {
+				return prefix_;
+			}
 
 		private:
 			N node_value_{};
+			[[no_unique_address]] detail::key_prefix<N> prefix_{};
+			std::size_t order_ = 0;
 		};
 
 		//   ----------
@@ -82,18 +272,33 @@ namespace gdwg {
 			: weight_{w} {
 				from_ptr_ = std::move(f);
 				to_ptr_ = std::move(t);
+				update_prefixes();
+				detail::count(detail::counter::weight_copies);
 			}
 
 			// edge getters
-			[[nodiscard]] auto get_edge_weight() const -> E {
+			[[nodiscard]] auto get_edge_weight() const -> E const& {
 				return weight_;
 			}
-			[[nodiscard]] auto get_from_node() const -> N {
+			[[nodiscard]] auto get_from_node() const -> N const& {
 				return from_ptr_->get_node_value();
 			}
-			[[nodiscard]] auto get_to_node() const -> N {
+			[[nodiscard]] auto get_to_node() const -> N const& {
 				return to_ptr_->get_node_value();
 			}
+			[[nodiscard]] auto get_from_node_ptr() const -> node* {
+				return from_ptr_.get();
+			}
+			[[nodiscard]] auto get_to_node_ptr() const -> node* {
+				return to_ptr_.get();
+			}
+			// the key prefixes of the nodes, kept here so ordering edges rarely reads the nodes
+			[[nodiscard]] auto get_from_prefix() const -> detail::key_prefix<N> {
+				return from_prefix_;
+			}
+			[[nodiscard]] auto get_to_prefix() const -> detail::key_prefix<N> {
+				return to_prefix_;
+			}
 			[[nodiscard]] auto get_from_count() const -> long {
 				return from_ptr_.use_count();
 			}
@@ -101,6 +306,8 @@ namespace gdwg {
 				return to_ptr_.use_count();
 			}
 			[[nodiscard]] auto get_edge_details() const -> value_type {
+				detail::count(detail::counter::node_value_copies, 2);
+				detail::count(detail::counter::weight_copies);
 				return value_type{from_ptr_->get_node_value(), to_ptr_->get_node_value(), weight_};
 			}
 
@@ -108,17 +315,82 @@ namespace gdwg {
 			auto set_from_ptr(std::shared_ptr<node> const& new_node_ptr) {
 				from_ptr_.reset();
 				from_ptr_ = std::move(new_node_ptr);
+				update_prefixes();
 			}
 			auto set_to_ptr(std::shared_ptr<node> const& new_node_ptr) {
 				to_ptr_.reset();
 				to_ptr_ = std::move(new_node_ptr);
+				update_prefixes();
+			}
+			// after a node's value changes (while the edge is out of the edge set)
+			auto update_prefixes() noexcept -> void {
+				from_prefix_ = from_ptr_->get_prefix();
+				to_prefix_ = to_ptr_->get_prefix();
 			}
 
 		private:
 			std::shared_ptr<node> from_ptr_;
 			std::shared_ptr<node> to_ptr_;
+			[[no_unique_address]] detail::key_prefix<N> from_prefix_{};
+			[[no_unique_address]] detail::key_prefix<N> to_prefix_{};
+			E weight_;
+		};
+
+		//   ---------------
+		//   FLAT EDGE CLASS
+		//   ---------------
+		// the edge kept by value when stores_edges_inline. Its node pointers are only compared or
+		// followed while the nodes are in the graph; operator-> lets an element of the edge set be
+		// used the same way whichever kind of edge it holds.
+		class flat_edge {
+		public:
+			flat_edge(node* f, node* t, E const& w) noexcept
+			: from_ptr_{f}
+			, to_ptr_{t}
+			, from_{f->get_node_value()}
+			, to_{t->get_node_value()}
+			, weight_{w} {
+				detail::count(detail::counter::node_value_copies, 2);
+				detail::count(detail::counter::weight_copies);
+			}
+
+			[[nodiscard]] auto operator->() const noexcept -> flat_edge const* {
+				return this;
+			}
+
+			// edge getters
+			[[nodiscard]] auto get_edge_weight() const -> E const& {
+				return weight_;
+			}
+			[[nodiscard]] auto get_from_node() const -> N const& {
+				return from_;
+			}
+			[[nodiscard]] auto get_to_node() const -> N const& {
+				return to_;
+			}
+			[[nodiscard]] auto get_from_node_ptr() const -> node* {
+				return from_ptr_;
+			}
+			[[nodiscard]] auto get_to_node_ptr() const -> node* {
+				return to_ptr_;
+			}
+			[[nodiscard]] auto get_edge_details() const -> value_type {
+				detail::count(detail::counter::node_value_copies, 2);
+				detail::count(detail::counter::weight_copies);
+				return value_type{from_, to_, weight_};
+			}
+
+		private:
+			node* from_ptr_;
+			node* to_ptr_;
+			N from_;
+			N to_;
 			E weight_;
 		};
+
+		// what the edge set holds
+		using edge_handle =
+		   std::conditional_t<stores_edges_inline, flat_edge, std::shared_ptr<edge>>;
 		// --------------------
 		// END OF INNER CLASSES
 		// ====================
@@ -128,7 +400,7 @@ namespace gdwg {
 		// CONSTRUCTORS (spec: section 2.2)
 		// --------------------------------
 		// constructor 1 ()
-		graph<N, E>() = default;
+		graph() = default;
 
 		// constructor 2 (ititializer_list)
 		graph(std::initializer_list<N> il)
@@ -136,24 +408,33 @@ namespace gdwg {
 
 		// constructor 3 (range[first,last] - nodes)
 		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
-		requires ranges::indirectly_copyable<I, N*> graph<N, E>(I first, S last) {
-			std::for_each(first, last, [this](N const& n) { insert_node(n); });
+		requires ranges::indirectly_copyable<I, N*> graph(I first, S last) {
+			auto values = std::vector<N>{};
+			ranges::for_each(first, last, [&values](N const& n) { values.push_back(n); });
+			build_node_list(std::move(values));
 		}
 
 		// constructor 4 (range[first,last] - nodes and edges)
 		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
 		requires ranges::indirectly_copyable<I, value_type*> graph(I first, S last) {
-			std::for_each(first, last, [this](value_type v) {
-				insert_node(v.from);
-				insert_node(v.to);
-				insert_edge(v.from, v.to, v.weight);
+			auto values = std::vector<value_type>{};
+			auto node_values = std::vector<N>{};
+			ranges::for_each(first, last, [&](value_type const& v) {
+				node_values.push_back(v.from);
+				node_values.push_back(v.to);
+				values.push_back(v);
 			});
+			build_node_list(std::move(node_values));
+			build_edge_list(std::move(values));
 		}
 
 		// move constructor
 		graph(graph&& other) noexcept
 		: node_list_{std::move(other.node_list_)}
-		, edge_list_{std::move(other.edge_list_)} {
+		, edge_list_{std::move(other.edge_list_)}
+		, topo_{std::exchange(other.topo_, {})}
+		, changes_{std::exchange(other.changes_, {})}
+		, cache_{std::move(other.cache_)} {
 			other.node_list_.clear();
 			other.edge_list_.clear();
 		}
@@ -162,12 +443,39 @@ namespace gdwg {
 		auto operator=(graph&& other) noexcept -> graph& {
 			node_list_ = std::move(other.node_list_);
 			edge_list_ = std::move(other.edge_list_);
+			topo_ = std::exchange(other.topo_, {});
+			changes_ = std::exchange(other.changes_, {});
+			cache_ = std::move(other.cache_);
 			other.node_list_.clear();
 			other.edge_list_.clear();
 			return *this;
 		}
-		// copy constructor
-		graph<N, E>(graph const&) = default;
+		// copy constructor (copies the nodes and edges, rather than sharing them with other)
+		graph(graph const& other)
+		: changes_{other.changes_} {
+			auto copies = std::unordered_map<node const*, std::shared_ptr<node>>{};
+			copies.reserve(other.node_list_.size());
+			for (auto const& node_ptr : other.node_list_) {
+				auto copy = make_node(*node_ptr);
+				copies.emplace(node_ptr.get(), copy);
+				node_list_.emplace_hint(node_list_.end(), std::move(copy));
+			}
+			for (auto const& edge_ptr : other.edge_list_) {
+				edge_list_.emplace_hint(edge_list_.end(),
+				                        make_edge(copies[edge_ptr->get_from_node_ptr()],
+				                                               copies[edge_ptr->get_to_node_ptr()],
+				                                               edge_ptr->get_edge_weight()));
+			}
+			topo_.enabled = other.topo_.enabled;
+			topo_.holes = other.topo_.holes;
+			topo_.order.reserve(other.topo_.order.size());
+			for (auto const* node_ptr : other.topo_.order) {
+				topo_.order.push_back(node_ptr != nullptr ? copies[node_ptr].get() : nullptr);
+			}
+			if (other.cache_) {
+				enable_query_cache(other.cache_->connections.capacity()); // cold
+			}
+		}
 
 		// copy assignment
 		auto operator=(graph const& other) noexcept -> graph& {
@@ -186,69 +494,156 @@ namespace gdwg {
 		// modifier 1 (inserting a node)
 		template<typename T>
 		auto insert_node(T const new_node) noexcept -> bool {
+			auto const scope = timed(graph_method::insert_node);
 			if (!is_node(new_node)) {
-				return node_list_.emplace(std::make_shared<node>(new_node)).second;
+				auto const [it, inserted] = node_list_.emplace(make_node(new_node));
+				if (topo_.enabled) {
+					(*it)->set_order(topo_.order.size()); // no edges yet, so last is as good as any
+					topo_.order.push_back(it->get());
+				}
+				if (changes_.enabled) {
+					record_change(change_kind::node_added, new_node);
+				}
+				return inserted;
 			}
 			return false;
 		}
 		// modifier 2 (inserting an edge)
 		template<typename T, typename U>
 		auto insert_edge(T f, T t, U w) -> bool {
+			auto const scope = timed(graph_method::insert_edge);
 			if (!is_node(f) or !is_node(t)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when either src "
 				                         "or dst node does not exist");
 			}
-			return edge_list_.emplace(std::make_shared<edge>(find_node(f), find_node(t), w)).second;
+			if (topo_.enabled) {
+				keep_topological_order(find_node(f).get(), find_node(t).get()); // throws on a cycle
+			}
+			auto const inserted =
+			   edge_list_.emplace(make_edge(find_node(f), find_node(t), w)).second;
+			if (inserted and cache_) {
+				forget_edge(f, t);
+			}
+			if (inserted and changes_.enabled) {
+				record_change(change_kind::edge_added, f, t, w);
+			}
+			return inserted;
 		}
 
 		// modifier 3 (replacing a node)
 		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			auto const scope = timed(graph_method::replace_node);
 			if (is_node(new_data)) {
 				return false;
 			}
-			if (is_node(old_data)) {
-				(*node_list_.find(old_data)).get()->set_node_value(new_data);
-			}
-			else {
+			if (!is_node(old_data)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::replace_node on a node "
 				                         "that doesn't exist");
 			}
+			// both sets are ordered on node values, so the node and every edge touching it are
+			// taken out while the value changes and put back afterwards. The node object itself is
+			// kept, so the edges (and the topological order) still point at it.
+			if (cache_) {
+				forget_node(old_data);
+			}
+			auto handle = node_list_.extract(node_list_.find(old_data));
+			auto* const node_ptr = handle.value().get();
+			auto touching = std::vector<edge_handle>{};
+			for (auto it = edge_list_.begin(); it != edge_list_.end();) {
+				if ((*it)->get_from_node_ptr() == node_ptr or (*it)->get_to_node_ptr() == node_ptr) {
+					if (cache_) {
+						forget_edge((*it)->get_from_node(), (*it)->get_to_node());
+					}
+					touching.push_back(*it);
+					it = edge_list_.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+			node_ptr->set_node_value(new_data);
+			node_list_.insert(std::move(handle));
+			for (auto& e : touching) {
+				if constexpr (stores_edges_inline) {
+					e = flat_edge(e->get_from_node_ptr(), e->get_to_node_ptr(), e->get_edge_weight());
+				}
+				else {
+					e->update_prefixes();
+				}
+				edge_list_.insert(std::move(e));
+			}
+			if (changes_.enabled) {
+				record_change(change_kind::node_renamed, old_data, new_data);
+			}
 			return true;
 		}
 
 		// modifier 4 (replacing a node and redirect weights to new node)
 		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			auto const scope = timed(graph_method::merge_replace_node);
 			if (!is_node(new_data) or !is_node(old_data)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node on old "
 				                         "or new data if they don't exist in the graph");
 			}
-			// get rid of old node
-			node_list_.erase(find_node(old_data));
-
-			if (edge_list_.empty()) {
-				return; // no edges - no point looking for them
+			if (old_data == new_data) {
+				return;
+			}
+			auto* const old_node = find_node(old_data).get();
+			auto* const new_node = find_node(new_data).get();
+			if (topo_.enabled and (reaches(old_node, new_node) or reaches(new_node, old_node))) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node when the "
+				                         "merge would create a cycle in the topological order");
 			}
-			// reroute edges
-			for (auto it_edge_ptr : edge_list_) {
-				if (it_edge_ptr->get_from_node() == old_data) {
-					it_edge_ptr->set_from_ptr(find_node(new_data));
+			// take out every edge to or from the old node (the set is ordered on the node values,
+			// so they can't be changed in place) and put them back against the new node, letting
+			// the set drop the ones that become duplicates
+			auto rerouted = std::vector<value_type>{};
+			for (auto it = edge_list_.begin(); it != edge_list_.end();) {
+				if ((*it)->get_from_node_ptr() == old_node or (*it)->get_to_node_ptr() == old_node) {
+					auto e = (*it)->get_edge_details();
+					e.from = e.from == old_data ? new_data : e.from;
+					e.to = e.to == old_data ? new_data : e.to;
+					rerouted.push_back(std::move(e));
+					it = edge_list_.erase(it);
 				}
-				if (it_edge_ptr->get_to_node() == old_data) {
-					it_edge_ptr->set_to_ptr(find_node(new_data));
+				else {
+					++it;
 				}
 			}
-			// get rid of duplicate edges
-			remove_duplicate_edges();
+			if (topo_.enabled) {
+				remove_from_topological_order(old_node);
+			}
+			node_list_.erase(find_node(old_data));
+			if (cache_) {
+				forget_node(old_data);
+				for (auto const& e : rerouted) {
+					forget_edge(e.from, e.to);
+				}
+			}
+			for (auto const& e : rerouted) {
+				if (topo_.enabled) {
+					keep_topological_order(find_node(e.from).get(), find_node(e.to).get());
+				}
+				edge_list_.emplace(
+				   make_edge(find_node(e.from), find_node(e.to), e.weight));
+			}
+			if (changes_.enabled) {
+				record_change(change_kind::node_merged, old_data, new_data);
+			}
 		}
 
 		// modifier 5 (erase node and edges from and to that node)
 		auto erase_node(N const& value) noexcept -> bool {
+			auto const scope = timed(graph_method::erase_node);
 			if (!is_node(value)) {
 				return false;
 			}
+			if (topo_.enabled) {
+				remove_from_topological_order(find_node(value).get());
+			}
 			if (node_list_.erase(find_node(value))) { // only remove edges if node is deleted
 				// collect pointers to edges that need to be removed
-				auto edges_2_delete = std::vector<std::shared_ptr<edge>>{};
+				auto edges_2_delete = std::vector<edge_handle>{};
 				for (auto it_edge_ptr : edge_list_) {
 					if (it_edge_ptr->get_from_node() == value) {
 						edges_2_delete.push_back(it_edge_ptr);
@@ -259,8 +654,17 @@ namespace gdwg {
 				}
 				//  delete those edges
 				for (auto edge_ptr : edges_2_delete) {
+					if (cache_) {
+						forget_edge(edge_ptr->get_from_node(), edge_ptr->get_to_node());
+					}
 					edge_list_.erase(edge_ptr);
 				}
+				if (cache_) {
+					forget_node(value);
+				}
+				if (changes_.enabled) {
+					record_change(change_kind::node_erased, value);
+				}
 				return true;
 			}
 			return false;
@@ -268,16 +672,26 @@ namespace gdwg {
 
 		// modifier 6 (remove an edge from the graph - with node/node/weight)
 		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			auto const scope = timed(graph_method::erase_edge);
 			if (!is_node(src) or !is_node(dst)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edge on src or dst "
 				                         "if they don't exist in the graph");
 			}
-			return (is_edge(src, dst, weight) // edge exists and it can be deleted
-			        and edge_list_.erase(find_edge(src, dst, weight)));
+			if (!is_edge(src, dst, weight) or !edge_list_.erase(find_edge(src, dst, weight))) {
+				return false;
+			}
+			if (cache_) {
+				forget_edge(src, dst);
+			}
+			if (changes_.enabled) {
+				record_change(change_kind::edge_erased, src, dst, weight);
+			}
+			return true;
 		}
 
 		// modifier 7 (remove an edge from graph - with an iterator)
 		auto erase_edge(iterator& it) -> iterator {
+			auto const scope = timed(graph_method::erase_edge);
 			if (it == this->end()) {
 				return it; // no edge to remove
 			}
@@ -290,20 +704,139 @@ namespace gdwg {
 
 		// modifier 8 (erases a range of edges)
 		auto erase_edge(iterator& i, iterator& s) -> iterator {
+			auto const scope = timed(graph_method::erase_edge);
 			if ((i == end()) or (i == s)) {
 				return i; // nothing to do
 			}
 
 			auto start_edge = get_value_type(i);
 			auto end_edge = s != end() ? get_value_type(s) : start_edge;
-			edge_list_.erase(edge_list_.find(start_edge), edge_list_.find(end_edge));
-			return start_edge == end_edge ? end() : find(end_edge.from, end_edge.to, end_edge.weight);
+			auto const first = edge_list_.find(start_edge);
+			auto const last = s != end() ? edge_list_.find(end_edge) : edge_list_.end();
+			if (cache_) {
+				for (auto it = first; it != last; ++it) {
+					forget_edge((*it)->get_from_node(), (*it)->get_to_node());
+				}
+			}
+			if (changes_.enabled) {
+				for (auto it = first; it != last; ++it) {
+					record_change(change_kind::edge_erased,
+					              (*it)->get_from_node(),
+					              (*it)->get_to_node(),
+					              (*it)->get_edge_weight());
+				}
+			}
+			edge_list_.erase(first, last);
+			return s == end() ? end() : find(end_edge.from, end_edge.to, end_edge.weight);
 		}
 
 		// modifier 9 (erases all nodes and edges from graph)
 		auto clear() noexcept -> void {
+			auto const scope = timed(graph_method::clear);
 			edge_list_.clear();
 			node_list_.clear();
+			topo_.order.clear();
+			topo_.holes = 0;
+			if (cache_) {
+				forget_all();
+			}
+			if (changes_.enabled) {
+				record_change(change_kind::cleared);
+			}
+		}
+
+		// modifier 10 (applies a patch from diff: erased edges, erased nodes, added nodes, then
+		// added edges). Throws if the patch doesn't fit, e.g. it erases something that isn't
+		// there, in which case the graph may be left partly patched.
+		auto apply(patch const& p) -> void {
+			auto const scope = timed(graph_method::apply);
+			auto const mismatch = [] {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::apply with a patch that "
+				                         "doesn't match the graph");
+			};
+			if (cache_) {
+				forget_all(); // a patch touches too much to be worth forgetting edge by edge
+			}
+			if (topo_.enabled or changes_.enabled) {
+				// one modifier at a time, so the order and the change stream are kept up to date
+				for (auto const& e : p.erased_edges) {
+					if (!is_node(e.from) or !is_node(e.to) or !erase_edge(e.from, e.to, e.weight)) {
+						mismatch();
+					}
+				}
+				for (auto const& n : p.erased_nodes) {
+					if (!erase_node(n)) {
+						mismatch();
+					}
+				}
+				for (auto const& n : p.added_nodes) {
+					if (!insert_node(n)) {
+						mismatch();
+					}
+				}
+				for (auto const& e : p.added_edges) {
+					if (!is_node(e.from) or !is_node(e.to) or !insert_edge(e.from, e.to, e.weight)) {
+						mismatch();
+					}
+				}
+				return;
+			}
+
+			for (auto const& e : p.erased_edges) {
+				auto const it = edge_list_.find(e);
+				if (it == edge_list_.end()) {
+					mismatch();
+				}
+				edge_list_.erase(it);
+			}
+			if (!p.erased_nodes.empty()) {
+				// one pass over the edges for all the erased nodes, rather than one per node
+				auto erased = std::unordered_set<node const*>{};
+				for (auto const& n : p.erased_nodes) {
+					auto const it = node_list_.find(n);
+					if (it == node_list_.end()) {
+						mismatch();
+					}
+					erased.insert(it->get());
+				}
+				absl::erase_if(edge_list_, [&erased](edge_handle const& e) {
+					return erased.contains(e->get_from_node_ptr())
+					       or erased.contains(e->get_to_node_ptr());
+				});
+				absl::erase_if(node_list_, [&erased](std::shared_ptr<node> const& n) {
+					return erased.contains(n.get());
+				});
+			}
+			// the lists are sorted, so each insertion usually lands right after the one before
+			auto node_hint = node_list_.begin();
+			for (auto const& n : p.added_nodes) {
+				auto const size = node_list_.size();
+				node_hint = std::next(node_list_.emplace_hint(node_hint, make_node(n)));
+				if (node_list_.size() == size) {
+					mismatch();
+				}
+			}
+			auto edge_hint = edge_list_.begin();
+			auto const* from = static_cast<std::shared_ptr<node> const*>(nullptr);
+			for (auto const& e : p.added_edges) {
+				if (from == nullptr or (*from)->get_node_value() != e.from) {
+					auto const it = node_list_.find(e.from);
+					if (it == node_list_.end()) {
+						mismatch();
+					}
+					from = &*it;
+				}
+				auto const to = node_list_.find(e.to);
+				if (to == node_list_.end()) {
+					mismatch();
+				}
+				auto const size = edge_list_.size();
+				auto const added = make_edge(*from, *to, e.weight);
+				edge_hint = std::next(edge_list_.emplace_hint(edge_hint, added));
+				if (edge_list_.size() == size) {
+					mismatch();
+				}
+			}
 		}
 
 		// =======================
@@ -311,6 +844,7 @@ namespace gdwg {
 		// -----------------------
 		// accessor 1 (checks if a value represents a node)
 		[[nodiscard]] auto is_node(N n) const noexcept -> bool {
+			auto const scope = timed(graph_method::is_node);
 			return node_list_.find(n) != node_list_.end();
 		}
 
@@ -321,57 +855,450 @@ namespace gdwg {
 
 		// accessor 3 (checks if two nodes are connected)
 		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const scope = timed(graph_method::is_connected);
 			if (!is_node(src) or !is_node(dst)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::is_connected if src or dst "
 				                         "node don't exist in the graph");
 			}
-			auto it1 = edge_list_.lower_bound(value_type{src, dst, std::numeric_limits<E>::min()});
-			return ((it1 != edge_list_.end()) and ((*it1)->get_from_node() == src)
-			        and ((*it1)->get_to_node() == dst));
+			return edge_list_.find(pair_key{src, dst}) != edge_list_.end();
 		}
 
 		// accessor 4 (returns a sequence of nodes
 		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			auto const scope = timed(graph_method::nodes);
 			auto node_sequence = std::vector<N>{};
 			for (auto node_ptr : node_list_) {
 				node_sequence.push_back(node_ptr->get_node_value());
 			}
+			detail::count(detail::counter::node_value_copies, node_sequence.size());
 			return node_sequence;
 		}
 
 		// accessor 5 (returns a sequence of weights)
 		[[nodiscard]] auto weights(N const& from, N const& to) const -> std::vector<E> {
+			auto const scope = timed(graph_method::weights);
+			if (cache_) {
+				auto const lock = std::scoped_lock(cache_->mutex);
+				if (auto const* hit = cache_->weights.find(pair_key{from, to})) {
+					++cache_->stats.hits;
+					detail::count(detail::counter::weight_copies, hit->size());
+					return *hit;
+				}
+				++cache_->stats.misses;
+			}
 			auto weights_sequence = std::vector<E>{};
 			if (!is_node(from) or !is_node(to)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::weights if src or dst node "
 				                         "don't exist in the graph");
 			}
-			auto w_it = edge_list_.lower_bound(value_type{from, to, std::numeric_limits<E>::min()});
-			while ((w_it != edge_list_.end()) and ((*w_it).get()->get_to_node() == to)) {
-				weights_sequence.push_back((*w_it).get()->get_edge_weight());
-				++w_it;
+			auto [w_it, w_end] = edge_list_.equal_range(pair_key{from, to});
+			for (; w_it != w_end; ++w_it) {
+				weights_sequence.push_back((*w_it)->get_edge_weight());
+			}
+			detail::count(detail::counter::weight_copies, weights_sequence.size());
+			if (cache_) {
+				auto const lock = std::scoped_lock(cache_->mutex);
+				cache_->stats.evictions +=
+				   cache_->weights.insert(std::pair<N, N>(from, to), weights_sequence) ? 1 : 0;
 			}
 			return weights_sequence;
 		}
 		// accessor 6 (return an iterator to an edge)
 		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
+			auto const scope = timed(graph_method::find);
 			return iterator(edge_list_, edge_list_.find(value_type{src, dst, weight}));
 		}
 		// accessor 7 (returns a sequence of nodes connected to a given node)
 		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			auto const scope = timed(graph_method::connections);
+			if (cache_) {
+				auto const lock = std::scoped_lock(cache_->mutex);
+				if (auto const* hit = cache_->connections.find(src)) {
+					++cache_->stats.hits;
+					detail::count(detail::counter::node_value_copies, hit->size());
+					return *hit;
+				}
+				++cache_->stats.misses;
+			}
 			auto connections = std::vector<N>{};
 			if (!is_node(src)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't "
 				                         "exist in the graph");
 			}
-			auto c_it = edge_list_.lower_bound(
-			   value_type{src, std::numeric_limits<N>::min(), std::numeric_limits<E>::min()});
-			while (c_it != edge_list_.end() and (*c_it).get()->get_from_node() == src) {
-				connections.push_back((*c_it).get()->get_to_node());
-				++c_it;
+			auto [c_it, c_end] = out_edges(src);
+			for (; c_it != c_end; ++c_it) {
+				connections.push_back((*c_it)->get_to_node());
+			}
+			detail::count(detail::counter::node_value_copies, connections.size());
+			if (cache_) {
+				auto const lock = std::scoped_lock(cache_->mutex);
+				cache_->stats.evictions += cache_->connections.insert(src, connections) ? 1 : 0;
 			}
 			return connections;
 		}
+		// accessor 8 (read-only CSR snapshot of the whole graph, for algorithms)
+		[[nodiscard]] auto freeze() const -> frozen_graph<N, E> {
+			auto const scope = timed(graph_method::freeze);
+			if (node_list_.size() > std::numeric_limits<node_id>::max()) {
+				throw std::length_error("Cannot call gdwg::graph<N, E>::freeze on a graph with more "
+				                        "nodes than gdwg::node_id can number");
+			}
+			auto ids = std::unordered_map<node const*, node_id>{};
+			ids.reserve(node_list_.size());
+			auto nodes = std::vector<N>{};
+			nodes.reserve(node_list_.size());
+			for (auto const& node_ptr : node_list_) {
+				ids.emplace(node_ptr.get(), static_cast<node_id>(nodes.size()));
+				nodes.push_back(node_ptr->get_node_value());
+			}
+			// edge_list_ is ordered by src, so every node's edges are already contiguous
+			auto offsets = std::vector<std::size_t>(nodes.size() + 1, 0);
+			auto targets = std::vector<node_id>{};
+			auto weights = std::vector<E>{};
+			targets.reserve(edge_list_.size());
+			weights.reserve(edge_list_.size());
+			for (auto const& edge_ptr : edge_list_) {
+				++offsets[ids.find(edge_ptr->get_from_node_ptr())->second + 1];
+				targets.push_back(ids.find(edge_ptr->get_to_node_ptr())->second);
+				weights.push_back(edge_ptr->get_edge_weight());
+			}
+			for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+				offsets[i + 1] += offsets[i];
+			}
+			return frozen_graph<N, E>(std::move(nodes),
+			                          std::move(offsets),
+			                          std::move(targets),
+			                          std::move(weights));
+		}
+
+		// accessor 9 (the patch that turns this graph into target). Walks both node lists and
+		// then both edge lists side by side, once, without looking anything up: O(V + E).
+		[[nodiscard]] auto diff(graph const& target) const -> patch {
+			auto const scope = timed(graph_method::diff);
+			auto result = patch{};
+			auto erased = std::unordered_set<node const*>{};
+			auto const value = [](std::shared_ptr<node> const& ptr) -> N const& {
+				return ptr->get_node_value();
+			};
+			auto a = node_list_.begin();
+			auto b = target.node_list_.begin();
+			auto const a_end = node_list_.end();
+			auto const b_end = target.node_list_.end();
+			while (a != a_end or b != b_end) {
+				if (b == b_end or (a != a_end and value(*a) < value(*b))) {
+					result.erased_nodes.push_back(value(*a));
+					erased.insert(a->get());
+					++a;
+				}
+				else if (a == a_end or value(*b) < value(*a)) {
+					result.added_nodes.push_back(value(*b));
+					++b;
+				}
+				else {
+					++a;
+					++b;
+				}
+			}
+			auto const less = edge_comparator{};
+			auto x = edge_list_.begin();
+			auto y = target.edge_list_.begin();
+			auto const x_end = edge_list_.end();
+			auto const y_end = target.edge_list_.end();
+			while (x != x_end or y != y_end) {
+				if (y == y_end or (x != x_end and less(*x, *y))) {
+					if (!erased.contains((*x)->get_from_node_ptr())
+					    and !erased.contains((*x)->get_to_node_ptr()))
+					{
+						result.erased_edges.push_back((*x)->get_edge_details());
+					}
+					++x;
+				}
+				else if (x == x_end or less(*y, *x)) {
+					result.added_edges.push_back((*y)->get_edge_details());
+					++y;
+				}
+				else {
+					++x;
+					++y;
+				}
+			}
+			return result;
+		}
+
+		// accessor 10 (iterators to the edges from src, which are consecutive in edge order)
+		[[nodiscard]] auto edges_from(N const& src) const -> std::pair<iterator, iterator> {
+			auto const scope = timed(graph_method::edges_from);
+			if (!is_node(src)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::edges_from if src doesn't "
+				                         "exist in the graph");
+			}
+			auto [first, last] = out_edges(src);
+			return {iterator(edge_list_, first), iterator(edge_list_, last)};
+		}
+
+		// accessor 11 (calls f(from, to, weight) for every edge, in edge order). Faster than the
+		// iterators over the whole graph: with shared edges each step has to load an edge and then
+		// its two nodes, so the scan prefetches the edges scan_distance ahead and their nodes half
+		// as far ahead, and the loads overlap instead of waiting on each other. Inline edges are
+		// read straight out of the tree's leaves. f must not change the graph.
+		template<typename F>
+		auto for_each_edge(F f) const -> void {
+			auto const scope = timed(graph_method::for_each_edge);
+			if constexpr (stores_edges_inline) {
+				for (auto const& e : edge_list_) {
+					f(e.get_from_node(), e.get_to_node(), e.get_edge_weight());
+				}
+			}
+			else {
+				auto const last = edge_list_.end();
+				auto edges_ahead = edge_list_.begin();
+				auto nodes_ahead = edge_list_.begin();
+				for (auto i = std::size_t{0}; i < scan_distance and edges_ahead != last; ++i) {
+					detail::prefetch(edges_ahead->get());
+					++edges_ahead;
+					if (i % 2 == 1) {
+						++nodes_ahead;
+					}
+				}
+				for (auto const& e : edge_list_) {
+					if (edges_ahead != last) {
+						detail::prefetch(edges_ahead->get());
+						++edges_ahead;
+					}
+					if (nodes_ahead != last) {
+						detail::prefetch((*nodes_ahead)->get_from_node_ptr());
+						detail::prefetch((*nodes_ahead)->get_to_node_ptr());
+						++nodes_ahead;
+					}
+					f(e->get_from_node(), e->get_to_node(), e->get_edge_weight());
+				}
+			}
+		}
+
+		// =================
+		// TOPOLOGICAL ORDER
+		// -----------------
+		// Opt-in. While enabled, insert_edge refuses (throws on) any edge that would close a cycle
+		// and otherwise repairs the order locally: only the nodes placed between the new edge's
+		// dst and src are looked at (Marchetti-Spaccamela et al., the forward-search-only
+		// relative of Pearce-Kelly). Erasing nodes or edges never invalidates the order.
+
+		// topological order 1 (start maintaining an order; throws if the graph has a cycle)
+		auto enable_topological_order() -> void {
+			if (!rebuild_topological_order()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::enable_topological_order "
+				                         "on a graph with a cycle");
+			}
+			topo_.enabled = true;
+		}
+
+		// topological order 2 (stop maintaining the order)
+		auto disable_topological_order() noexcept -> void {
+			topo_ = {};
+		}
+
+		// topological order 3 (checks if an order is being maintained)
+		[[nodiscard]] auto has_topological_order() const noexcept -> bool {
+			return topo_.enabled;
+		}
+
+		// topological order 4 (returns the nodes so that every edge goes from earlier to later)
+		[[nodiscard]] auto topo_order() const -> std::vector<N> {
+			if (!topo_.enabled) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::topo_order when no "
+				                         "topological order is being maintained");
+			}
+			auto order = std::vector<N>{};
+			order.reserve(topo_.order.size() - topo_.holes);
+			for (auto const* node_ptr : topo_.order) {
+				if (node_ptr != nullptr) {
+					order.push_back(node_ptr->get_node_value());
+				}
+			}
+			return order;
+		}
+
+		// =============
+		// CHANGE STREAM
+		// -------------
+		// Opt-in. While enabled, every modifier that changes the graph appends typed changes to a
+		// log, numbered from 1 up. Consumers keep the sequence number they have read up to and
+		// pull what came after it, so keeping a copy in sync costs O(changes) rather than a diff
+		// of both graphs. Only the last `retain` changes are kept.
+
+		static constexpr auto all_changes = std::numeric_limits<std::size_t>::max();
+
+		// change stream 1 (start recording, keeping at most retain changes)
+		auto enable_change_stream(std::size_t retain = std::size_t{1} << 16U) -> void {
+			changes_.enabled = true;
+			changes_.retain = std::max(retain, std::size_t{1});
+			while (changes_.log.size() > changes_.retain) {
+				changes_.log.pop_front();
+			}
+		}
+
+		// change stream 2 (stop recording and drop the recorded changes; numbering carries on)
+		auto disable_change_stream() noexcept -> void {
+			changes_.enabled = false;
+			changes_.log.clear();
+		}
+
+		// change stream 3 (checks if changes are being recorded)
+		[[nodiscard]] auto has_change_stream() const noexcept -> bool {
+			return changes_.enabled;
+		}
+
+		// change stream 4 (the sequence number the next change will get)
+		[[nodiscard]] auto change_sequence() const noexcept -> std::uint64_t {
+			return changes_.next;
+		}
+
+		// change stream 5 (up to max changes, oldest first, from sequence number `from` on).
+		// Throws if some of them are no longer retained, after which the consumer has to start
+		// again from a full copy of the graph and change_sequence().
+		[[nodiscard]] auto changes_since(std::uint64_t from, std::size_t max = all_changes) const
+		   -> change_batch {
+			auto const oldest = changes_.next - changes_.log.size();
+			if (from < oldest) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::changes_since on changes "
+				                         "that are no longer retained");
+			}
+			auto batch = change_batch{{}, std::max(from, changes_.next)};
+			if (from >= changes_.next) {
+				return batch;
+			}
+			auto const first = changes_.log.begin() + static_cast<std::ptrdiff_t>(from - oldest);
+			auto const count = std::min(max, static_cast<std::size_t>(changes_.log.end() - first));
+			batch.changes.assign(first, first + static_cast<std::ptrdiff_t>(count));
+			batch.next = from + count;
+			return batch;
+		}
+
+		// ===========
+		// QUERY CACHE
+		// -----------
+		// Opt-in. While enabled, connections() and weights() keep their latest results, up to
+		// capacity of each, and answer repeats from the cache without searching the edges. A full
+		// cache makes room by CLOCK (see detail::clock_cache), which keeps the hot entries of a
+		// skewed workload at little cost per hit. Modifiers drop exactly the results they change:
+		// an edge from src to dst drops connections(src) and weights(src, dst), and erasing,
+		// renaming or merging a node also drops every result about it. clear() and apply() drop
+		// everything. Const calls from several threads stay safe (the cache has its own lock), and
+		// a copy of the graph starts with an empty cache of the same capacity.
+
+		// query cache 1 (start caching, or resize the cache and drop what it holds)
+		auto enable_query_cache(std::size_t capacity = 1024) -> void {
+			cache_ = std::make_unique<query_cache>(capacity);
+		}
+
+		// query cache 2 (stop caching and drop the cached results and the counts)
+		auto disable_query_cache() noexcept -> void {
+			cache_.reset();
+		}
+
+		// query cache 3 (checks if results are being cached)
+		[[nodiscard]] auto has_query_cache() const noexcept -> bool {
+			return cache_ != nullptr;
+		}
+
+		// query cache 4 (hits, misses, evictions and invalidations since the cache was enabled;
+		// all zeros without a cache)
+		[[nodiscard]] auto query_cache_counts() const -> query_cache_stats {
+			if (!cache_) {
+				return {};
+			}
+			auto const lock = std::scoped_lock(cache_->mutex);
+			auto result = cache_->stats;
+			result.size = cache_->connections.size() + cache_->weights.size();
+			result.capacity = cache_->connections.capacity();
+			return result;
+		}
+
+		// ===============
+		// INSTRUMENTATION
+		// ---------------
+		// Compiled in only with GDWG_GRAPH_STATS (see stats.hpp); otherwise stats() is all zeros
+		// and the sink is never called. Copies and moves of a graph start from zero, with no sink.
+
+		// instrumentation 1 (what this graph has done so far)
+		[[nodiscard]] auto stats() const -> graph_stats {
+			return counters_.snapshot();
+		}
+
+		// instrumentation 2 (called after each public method call; an empty sink removes it)
+		auto set_trace_sink(trace_sink sink) -> void {
+			counters_.set_sink(std::move(sink));
+		}
+
+		// ======
+		// MEMORY
+		// ------
+		// For budgeting: what the graph holds on to, by category (see memory_footprint), and a way
+		// to give back what it no longer needs. Node values and weights that own heap memory are
+		// counted through heap_bytes<N> and heap_bytes<E>.
+
+		// memory 1 (an estimate of the bytes held; O(1) unless N, E or the change stream hold
+		// heap memory, then O(V + E + changes), plus O(cached results) with a query cache)
+		[[nodiscard]] auto memory_usage() const -> memory_footprint {
+			auto usage = memory_footprint{};
+			usage.nodes = node_list_.size() * detail::shared_allocation_bytes<node>;
+			usage.index = node_list_.size() * detail::tree_slot_bytes<std::shared_ptr<node>>
+			              + topo_.order.capacity() * sizeof(node*);
+			if constexpr (stores_edges_inline) {
+				// the edges are the tree's elements
+				usage.edges = edge_list_.size() * sizeof(flat_edge);
+				usage.index +=
+				   edge_list_.size() * (detail::tree_slot_bytes<flat_edge> - sizeof(flat_edge));
+			}
+			else {
+				usage.edges = edge_list_.size() * detail::shared_allocation_bytes<edge>;
+				usage.index += edge_list_.size() * detail::tree_slot_bytes<edge_handle>;
+			}
+			usage.change_log = changes_.log.size() * sizeof(change);
+			if (cache_) {
+				// keys are held twice, in the slots and in the index
+				auto const lock = std::scoped_lock(cache_->mutex);
+				cache_->connections.for_each([&](N const& src, std::vector<N> const& result) {
+					usage.index += 2 * sizeof(src) + sizeof(result)
+					               + detail::tree_slot_bytes<std::pair<N, std::size_t>>;
+					usage.payload += heap_bytes<N>::of(src) + heap_bytes<std::vector<N>>::of(result);
+				});
+				cache_->weights.for_each([&](std::pair<N, N> const& key, std::vector<E> const& result) {
+					usage.index += 2 * sizeof(key) + sizeof(result)
+					               + detail::tree_slot_bytes<std::pair<std::pair<N, N>, std::size_t>>;
+					usage.payload += 2 * (heap_bytes<N>::of(key.first) + heap_bytes<N>::of(key.second))
+					                 + heap_bytes<std::vector<E>>::of(result);
+				});
+			}
+			if constexpr (!std::is_trivially_copyable_v<N>) {
+				for (auto const& node_ptr : node_list_) {
+					usage.payload += heap_bytes<N>::of(node_ptr->get_node_value());
+				}
+				for (auto const& c : changes_.log) {
+					usage.change_log += heap_bytes<N>::of(c.from) + heap_bytes<N>::of(c.to);
+				}
+			}
+			if constexpr (!std::is_trivially_copyable_v<E>) {
+				for (auto const& edge_ptr : edge_list_) {
+					usage.payload += heap_bytes<E>::of(edge_ptr->get_edge_weight());
+				}
+				for (auto const& c : changes_.log) {
+					usage.change_log += heap_bytes<E>::of(c.weight);
+				}
+			}
+			return usage;
+		}
+
+		// memory 2 (drops the holes erased nodes left in the topological order and releases the
+		// spare capacity of the order and the change log). Nodes and edges are allocated one by
+		// one, so they have nothing to give back.
+		auto shrink_to_fit() -> void {
+			if (topo_.holes != 0) {
+				compact_topological_order();
+			}
+			topo_.order.shrink_to_fit();
+			changes_.log.shrink_to_fit();
+		}
 
 		// ==========================
 		// RANGE ACCESS (section 2.5)
@@ -379,7 +1306,7 @@ namespace gdwg {
 
 		// range access 1 (return iterator to first element in graph)
 		[[nodiscard]] auto begin() const -> iterator {
-			// std::set<std::shared_ptr<edge>, edge_comparator> const& temp = edge_list_;
+			// edge_set const& temp = edge_list_;
 			return iterator(edge_list_, edge_list_.begin());
 		}
 
@@ -448,13 +1375,74 @@ namespace gdwg {
 		// ========================
 		// Helper/utility functions
 		// ------------------------
+		auto record_change(change_kind kind,
+		                   N const& from = N{},
+		                   N const& to = N{},
+		                   E const& weight = E{}) -> void {
+			if (changes_.log.size() == changes_.retain) {
+				changes_.log.pop_front();
+			}
+			changes_.log.push_back(change{changes_.next++, kind, from, to, weight});
+		}
+
+		// how many edges ahead for_each_edge prefetches: enough to cover a miss to memory at a
+		// few nanoseconds an edge, few enough that the lines are still cached when they are read
+		static constexpr auto scan_distance = std::size_t{16};
+
+		// ======================
+		// Query cache (helpers)
+		// ----------------------
+		// drops the results an edge from -> to is part of
+		auto forget_edge(N const& from, N const& to) -> void {
+			cache_->stats.invalidations += (cache_->connections.erase(from) ? 1U : 0U)
+			                               + (cache_->weights.erase(pair_key{from, to}) ? 1U : 0U);
+		}
+		// drops every result about value, including weights to or from it between nodes that have
+		// no edge (which throw once value is gone)
+		auto forget_node(N const& value) -> void {
+			cache_->stats.invalidations += (cache_->connections.erase(value) ? 1U : 0U);
+			auto const about_value = [&value](std::pair<N, N> const& key) {
+				return key.first == value or key.second == value;
+			};
+			cache_->stats.invalidations += cache_->weights.erase_if(about_value);
+		}
+		auto forget_all() -> void {
+			cache_->stats.invalidations += cache_->connections.size() + cache_->weights.size();
+			cache_->connections.clear();
+			cache_->weights.clear();
+		}
+
+		// times the enclosing public method (when instrumented)
+		[[nodiscard]] auto timed(graph_method method) const -> detail::method_scope<stats_enabled> {
+			return detail::method_scope<stats_enabled>(counters_, method);
+		}
+
+		template<typename... Args>
+		static auto make_node(Args&&... args) -> std::shared_ptr<node> {
+			detail::count(detail::counter::make_shared_calls);
+			detail::count(detail::counter::allocations);
+			return std::make_shared<node>(std::forward<Args>(args)...);
+		}
+		static auto make_edge(std::shared_ptr<node> const& from,
+		                      std::shared_ptr<node> const& to,
+		                      E const& weight) -> edge_handle {
+			if constexpr (stores_edges_inline) {
+				return flat_edge(from.get(), to.get(), weight);
+			}
+			else {
+				detail::count(detail::counter::make_shared_calls);
+				detail::count(detail::counter::allocations);
+				return std::make_shared<edge>(from, to, weight);
+			}
+		}
+
 		auto find_node(N n) -> std::shared_ptr<node> const& {
 			return *node_list_.find(n);
 		}
-		auto find_edge(N const& src, N const& dst, E const& weight) -> std::shared_ptr<edge> const& {
+		auto find_edge(N const& src, N const& dst, E const& weight) -> edge_handle const& {
 			return *edge_list_.find(value_type{src, dst, weight});
 		}
-		auto find_edge(value_type e) -> std::shared_ptr<edge> const& {
+		auto find_edge(value_type e) -> edge_handle const& {
 			return *edge_list_.find(e);
 		}
 		auto get_value_type(iterator& it) -> value_type {
@@ -463,71 +1451,386 @@ namespace gdwg {
 		[[nodiscard]] auto is_edge(N const& src, N const& dst, E const& weight) -> bool {
 			return edge_list_.find(value_type{src, dst, weight}) != edge_list_.end();
 		}
-		auto remove_duplicate_edges() noexcept {
-			auto edges_to_delete = std::vector<value_type>{};
-			auto it_edge_ptr = edge_list_.begin();
-			auto prev = (*it_edge_ptr++)->get_edge_details();
-			while (it_edge_ptr != edge_list_.end()) {
-				if ((*it_edge_ptr)->get_edge_details() == prev) {
-					edges_to_delete.push_back(prev);
+		// bulk construction (constructors 3 and 4). Both expect the list they build to be empty:
+		// the values are sorted in parallel, then each block de-duplicates its own range and
+		// allocates its nodes/edges on its own thread, and the sorted results are appended to the
+		// set with an end() hint, which is amortised constant time per element.
+		auto build_node_list(std::vector<N> values) -> void {
+			detail::parallel_sort(values, std::less<>{});
+			auto nodes = std::vector<std::shared_ptr<node>>(values.size());
+			detail::parallel_blocks(values.size(), [&](std::size_t, std::size_t i, std::size_t last) {
+				for (; i != last; ++i) {
+					if (i == 0 or values[i - 1] != values[i]) {
+						nodes[i] = make_node(values[i]);
+					}
+				}
+			});
+			for (auto& node_ptr : nodes) {
+				if (node_ptr) {
+					node_list_.emplace_hint(node_list_.end(), std::move(node_ptr));
+				}
+			}
+		}
+		auto build_edge_list(std::vector<value_type> values) -> void {
+			detail::parallel_sort(values, [](value_type const& x, value_type const& y) {
+				return std::tie(x.from, x.to, x.weight) < std::tie(y.from, y.to, y.weight);
+			});
+			auto segments = std::vector<std::vector<edge_handle>>(
+			   detail::block_count(values.size()));
+			auto const n = values.size();
+			detail::parallel_blocks(n, [&](std::size_t block, std::size_t i, std::size_t last) {
+				auto& segment = segments[block];
+				segment.reserve(last - i);
+				auto from_ptr = std::shared_ptr<node>{};
+				for (; i != last; ++i) {
+					auto const& v = values[i];
+					if (i != 0 and values[i - 1] == v) {
+						continue; // duplicate edge
+					}
+					if (!from_ptr or from_ptr->get_node_value() != v.from) {
+						from_ptr = *node_list_.find(v.from); // edges are grouped by src
+					}
+					auto const& to_ptr = *node_list_.find(v.to);
+					segment.push_back(make_edge(from_ptr, to_ptr, v.weight));
+				}
+			});
+			for (auto& segment : segments) {
+				for (auto& edge_ptr : segment) {
+					edge_list_.emplace_hint(edge_list_.end(), std::move(edge_ptr));
+				}
+			}
+		}
+		// all the edges from src, as a range of edge_list_
+		[[nodiscard]] auto out_edges(N const& src) const {
+			return edge_list_.equal_range(src_key{src});
+		}
+
+		// ============================
+		// Topological order (helpers)
+		// ----------------------------
+		// collects in reached the nodes reachable from start through nodes placed no later than
+		// bound (start included). Returns true, stopping early, if target is reached.
+		auto search_forward(node* start,
+		                    std::size_t bound,
+		                    node const* target,
+		                    std::vector<node*>& reached,
+		                    std::unordered_set<node const*>& seen) const -> bool {
+			reached.push_back(start);
+			seen.insert(start);
+			for (auto i = std::size_t{0}; i < reached.size(); ++i) {
+				auto [first, last] = out_edges(reached[i]->get_node_value());
+				for (; first != last; ++first) {
+					auto* const next = (*first)->get_to_node_ptr();
+					if (next == target) {
+						return true;
+					}
+					if (next->get_order() <= bound and seen.insert(next).second) {
+						reached.push_back(next);
+					}
+				}
+			}
+			return false;
+		}
+
+		// checks if there is a path from -> to (only needs to look between the two)
+		[[nodiscard]] auto reaches(node* from, node const* to) const -> bool {
+			auto reached = std::vector<node*>{};
+			auto seen = std::unordered_set<node const*>{};
+			return from->get_order() < to->get_order()
+			       and search_forward(from, to->get_order(), to, reached, seen);
+		}
+
+		// makes room for a new edge from -> to. If `to` is already placed after `from` nothing
+		// changes; otherwise the nodes `to` reaches within [order(to), order(from)] are moved,
+		// keeping their relative order, to just after `from`, and the rest of that window shifts
+		// down to make room. Throws, leaving everything unchanged, if the edge would be a cycle.
+		auto keep_topological_order(node* from, node* to) -> void {
+			auto const lower = to->get_order();
+			auto const upper = from->get_order();
+			if (lower > upper) {
+				return;
+			}
+			auto reached = std::vector<node*>{};
+			auto seen = std::unordered_set<node const*>{};
+			if (from == to or search_forward(to, upper, from, reached, seen)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when the edge "
+				                         "would create a cycle in the topological order");
+			}
+			std::sort(reached.begin(), reached.end(), [](node const* x, node const* y) {
+				return x->get_order() < y->get_order();
+			});
+			auto stay = std::vector<node*>{};
+			for (auto i = lower; i <= upper; ++i) {
+				if (topo_.order[i] != nullptr and !seen.contains(topo_.order[i])) {
+					stay.push_back(topo_.order[i]);
 				}
-				++it_edge_ptr;
 			}
-			for (auto i : edges_to_delete) {
-				erase_edge(i.from, i.to, i.weight);
+			// any holes in the window go first, then the nodes that stay, then the moved ones
+			auto i = upper + 1 - stay.size() - reached.size();
+			std::fill(topo_.order.begin() + static_cast<std::ptrdiff_t>(lower),
+			          topo_.order.begin() + static_cast<std::ptrdiff_t>(i),
+			          nullptr);
+			for (auto* const moved : {&stay, &reached}) {
+				for (auto* const node_ptr : *moved) {
+					node_ptr->set_order(i);
+					topo_.order[i++] = node_ptr;
+				}
 			}
 		}
+
+		// leaves a hole where the node was, compacting once holes are half the order
+		auto remove_from_topological_order(node const* node_ptr) noexcept -> void {
+			topo_.order[node_ptr->get_order()] = nullptr;
+			if (++topo_.holes * 2 > topo_.order.size()) {
+				compact_topological_order();
+			}
+		}
+
+		// closes up the holes, renumbering the nodes after them
+		auto compact_topological_order() noexcept -> void {
+			topo_.order.erase(std::remove(topo_.order.begin(), topo_.order.end(), nullptr),
+			                  topo_.order.end());
+			for (auto i = std::size_t{0}; i < topo_.order.size(); ++i) {
+				topo_.order[i]->set_order(i);
+			}
+			topo_.holes = 0;
+		}
+
+		// Kahn's algorithm over the whole graph; returns false (leaving topo_ alone) on a cycle
+		auto rebuild_topological_order() -> bool {
+			auto in_degree = std::unordered_map<node const*, std::size_t>{};
+			in_degree.reserve(node_list_.size());
+			for (auto const& edge_ptr : edge_list_) {
+				++in_degree[edge_ptr->get_to_node_ptr()];
+			}
+			auto order = std::vector<node*>{};
+			order.reserve(node_list_.size());
+			for (auto const& node_ptr : node_list_) {
+				if (!in_degree.contains(node_ptr.get())) {
+					order.push_back(node_ptr.get());
+				}
+			}
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				auto [first, last] = out_edges(order[i]->get_node_value());
+				for (; first != last; ++first) {
+					auto* const next = (*first)->get_to_node_ptr();
+					if (--in_degree[next] == 0) {
+						order.push_back(next);
+					}
+				}
+			}
+			if (order.size() != node_list_.size()) {
+				return false;
+			}
+			for (auto i = std::size_t{0}; i < order.size(); ++i) {
+				order[i]->set_order(i);
+			}
+			topo_.order = std::move(order);
+			topo_.holes = 0;
+			return true;
+		}
+
 		// ===========
 		// COMPARATORS
 		// -----------
+		// Node values are ordered by their key prefixes first (see detail::key_prefix), so two
+		// strings that differ early are told apart without reading either. A stored node is
+		// compared through a node_ref, which carries the prefix from wherever it is kept (the edge
+		// or the node) and reads the node only on a tie. Two refs to one node are equal outright.
+		struct node_ref {
+			detail::key_prefix<N> prefix;
+			node const* ptr;
+		};
+		[[nodiscard]] static auto key_less(node_ref x, node_ref y) -> bool {
+			if (auto const c = x.prefix.compare(y.prefix); c != 0) {
+				return c < 0;
+			}
+			return x.ptr != y.ptr and x.ptr->get_node_value() < y.ptr->get_node_value();
+		}
+		[[nodiscard]] static auto key_less(node_ref x, N const& y) -> bool {
+			if (auto const c = x.prefix.compare(detail::key_prefix<N>(y)); c != 0) {
+				return c < 0;
+			}
+			return x.ptr->get_node_value() < y;
+		}
+		[[nodiscard]] static auto key_less(N const& x, node_ref y) -> bool {
+			if (auto const c = detail::key_prefix<N>(x).compare(y.prefix); c != 0) {
+				return c < 0;
+			}
+			return x < y.ptr->get_node_value();
+		}
+		[[nodiscard]] static auto key_less(N const& x, N const& y) -> bool {
+			return x < y;
+		}
+		[[nodiscard]] static auto key_equal(node_ref x, node_ref y) -> bool {
+			return x.ptr == y.ptr
+			       or (x.prefix.compare(y.prefix) == 0
+			           and x.ptr->get_node_value() == y.ptr->get_node_value());
+		}
+		[[nodiscard]] static auto key_equal(node_ref x, N const& y) -> bool {
+			return x.prefix.compare(detail::key_prefix<N>(y)) == 0 and x.ptr->get_node_value() == y;
+		}
+		[[nodiscard]] static auto key_equal(N const& x, node_ref y) -> bool {
+			return key_equal(y, x);
+		}
+		[[nodiscard]] static auto key_equal(N const& x, N const& y) -> bool {
+			return x == y;
+		}
+		[[nodiscard]] static auto ref(std::shared_ptr<node> const& n) -> node_ref {
+			return node_ref{n->get_prefix(), n.get()};
+		}
+
 		struct node_comparator {
 			using is_transparent = std::true_type;
 
 			auto operator()(std::shared_ptr<node> const& x, std::shared_ptr<node> const& y) const
 			   -> bool {
-				return x->get_node_value() < y->get_node_value();
+				detail::count(detail::counter::node_comparisons);
+				return key_less(ref(x), ref(y));
 			}
 			auto operator()(std::shared_ptr<node> const& x, N const& y) const -> bool {
-				return x->get_node_value() < y;
+				detail::count(detail::counter::node_comparisons);
+				return key_less(ref(x), y);
 			}
 			auto operator()(N const& x, std::shared_ptr<node> const& y) const -> bool {
-				return x < y->get_node_value();
+				detail::count(detail::counter::node_comparisons);
+				return key_less(x, ref(y));
 			}
 		};
+		// match every edge from one src, or between one src and dst (with find/equal_range)
+		struct src_key {
+			N const& from;
+		};
+		struct pair_key {
+			N const& from;
+			N const& to;
+		};
 		struct edge_comparator {
 			using is_transparent = std::true_type;
-			auto operator()(std::shared_ptr<edge> const& x, std::shared_ptr<edge> const& y) const
-			   -> bool {
-				if (x->get_from_node() != y->get_from_node()) {
-					return x->get_from_node() < y->get_from_node();
+
+			// the ends of a stored edge, as compared: an inline edge's own copies of the values,
+			// otherwise refs to the nodes
+			[[nodiscard]] static auto from(edge_handle const& e) -> decltype(auto) {
+				if constexpr (stores_edges_inline) {
+					return e->get_from_node();
+				}
+				else {
+					return node_ref{e->get_from_prefix(), e->get_from_node_ptr()};
+				}
+			}
+			[[nodiscard]] static auto to(edge_handle const& e) -> decltype(auto) {
+				if constexpr (stores_edges_inline) {
+					return e->get_to_node();
+				}
+				else {
+					return node_ref{e->get_to_prefix(), e->get_to_node_ptr()};
+				}
+			}
+
+			auto operator()(edge_handle const& x, pair_key const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				if (!key_equal(from(x), y.from)) {
+					return key_less(from(x), y.from);
+				}
+				return key_less(to(x), y.to);
+			}
+			auto operator()(pair_key const& x, edge_handle const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				if (!key_equal(x.from, from(y))) {
+					return key_less(x.from, from(y));
 				}
-				if (x->get_to_node() != y->get_to_node()) {
-					return x->get_to_node() < y->get_to_node();
+				return key_less(x.to, to(y));
+			}
+			auto operator()(edge_handle const& x, src_key const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				return key_less(from(x), y.from);
+			}
+			auto operator()(src_key const& x, edge_handle const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				return key_less(x.from, from(y));
+			}
+			auto operator()(edge_handle const& x, edge_handle const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				if (!key_equal(from(x), from(y))) {
+					return key_less(from(x), from(y));
+				}
+				if (!key_equal(to(x), to(y))) {
+					return key_less(to(x), to(y));
 				}
 				return x->get_edge_weight() < y->get_edge_weight();
 			}
-			auto operator()(std::shared_ptr<edge> const& x, value_type const& y) const -> bool {
-				if (x->get_from_node() != y.from) {
-					return x->get_from_node() < y.from;
+			auto operator()(edge_handle const& x, value_type const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				if (!key_equal(from(x), y.from)) {
+					return key_less(from(x), y.from);
 				}
-				if (x->get_to_node() != y.to) {
-					return x->get_to_node() < y.to;
+				if (!key_equal(to(x), y.to)) {
+					return key_less(to(x), y.to);
 				}
 				return x->get_edge_weight() < y.weight;
 			}
-			auto operator()(value_type const& x, std::shared_ptr<edge> const& y) const -> bool {
-				if (x.from != y->get_from_node()) {
-					return x.from < y->get_from_node();
+			auto operator()(value_type const& x, edge_handle const& y) const -> bool {
+				detail::count(detail::counter::edge_comparisons);
+				if (!key_equal(x.from, from(y))) {
+					return key_less(x.from, from(y));
 				}
-				if (x.to != y->get_to_node()) {
-					return x.to < y->get_to_node();
+				if (!key_equal(x.to, to(y))) {
+					return key_less(x.to, to(y));
 				}
 				return x.weight < y->get_edge_weight();
 			}
 		};
 
-		std::set<std::shared_ptr<node>, node_comparator> node_list_{}; // NODE LIST (SET)
-		std::set<std::shared_ptr<edge>, edge_comparator> edge_list_{}; // EDGE LIST (SET)
+		using node_set = detail::tree<std::shared_ptr<node>, node_comparator>;
+		using edge_set = detail::tree<edge_handle, edge_comparator>;
+		node_set node_list_{}; // NODE LIST (SET)
+		edge_set edge_list_{}; // EDGE LIST (SET)
+
+		// dynamic topological order (opt-in): every node by position, with nullptr left behind by
+		// erased nodes until there are enough to compact
+		struct topological_order {
+			bool enabled = false;
+			std::vector<node*> order{};
+			std::size_t holes = 0;
+		};
+		topological_order topo_{};
+
+		// change stream (opt-in): the last `retain` changes, the newest numbered next - 1
+		struct change_log {
+			bool enabled = false;
+			std::size_t retain = 0;
+			std::uint64_t next = 1;
+			std::deque<change> log{};
+		};
+		change_log changes_{};
+
+		// query cache (opt-in): recent results of connections(src) and weights(src, dst). The
+		// cache is looked up by a pair_key, so a hit copies no node values.
+		struct pair_less {
+			using is_transparent = std::true_type;
+			auto operator()(std::pair<N, N> const& x, std::pair<N, N> const& y) const -> bool {
+				return x < y;
+			}
+			auto operator()(std::pair<N, N> const& x, pair_key const& y) const -> bool {
+				return x.first < y.from or (!(y.from < x.first) and x.second < y.to);
+			}
+			auto operator()(pair_key const& x, std::pair<N, N> const& y) const -> bool {
+				return x.from < y.first or (!(y.first < x.from) and x.to < y.second);
+			}
+		};
+		struct query_cache {
+			explicit query_cache(std::size_t capacity)
+			: connections{capacity}
+			, weights{capacity} {}
+			std::mutex mutex{};
+			detail::clock_cache<N, std::vector<N>, std::less<>> connections;
+			detail::clock_cache<std::pair<N, N>, std::vector<E>, pair_less> weights;
+			query_cache_stats stats{};
+		};
+		std::unique_ptr<query_cache> cache_{};
+
+		// instrumentation counters (an empty member unless GDWG_GRAPH_STATS is defined)
+		[[no_unique_address]] mutable detail::graph_counters<stats_enabled> counters_{};
 	};
 	//   ==============
 	//   ITERATOR CLASS
@@ -539,21 +1842,21 @@ namespace gdwg {
 		using value_type = ranges::common_tuple<N, N, E>;
 		using difference_type = std::ptrdiff_t;
 		using iterator_category = std::bidirectional_iterator_tag;
-		using graph_iterator = typename std::set<std::shared_ptr<edge>>::const_iterator;
+		using graph_iterator = typename edge_set::const_iterator;
 
 		// iterator constructor
 		iterator() = default;
-		explicit iterator(std::set<std::shared_ptr<edge>, edge_comparator> const& edge_list,
+		explicit iterator(edge_set const& edge_list,
 		                  graph_iterator const& it)
-		: edge_list_ref_(edge_list)
+		: edge_list_(&edge_list)
 		, iterator_(it) {}
 
 		// iterator source
-		auto operator*() -> ranges::common_tuple<N const&, N const&, E const&> {
+		auto operator*() const -> ranges::common_tuple<N const&, N const&, E const&> {
 			using graph_tuple = ranges::common_tuple<N const&, N const&, E const&>;
-			return graph_tuple{std::make_tuple((*iterator_).get()->get_from_node(),
-			                                   (*iterator_).get()->get_to_node(),
-			                                   (*iterator_).get()->get_edge_weight())};
+			return graph_tuple{(*iterator_)->get_from_node(),
+			                   (*iterator_)->get_to_node(),
+			                   (*iterator_)->get_edge_weight()};
 		}
 
 		// iterator traversal
@@ -586,10 +1889,23 @@ namespace gdwg {
 
 	private:
 		// explicit iterator(unspecified);
-		std::set<std::shared_ptr<edge>, edge_comparator> const& edge_list_ref_;
-		graph_iterator iterator_;
+		edge_set const* edge_list_ = nullptr;
+		graph_iterator iterator_{};
 	}; // end of interator
 
+	// the patch that turns a into b (see graph::diff)
+	template<typename N, typename E>
+	[[nodiscard]] auto diff(graph<N, E> const& a, graph<N, E> const& b)
+	   -> typename graph<N, E>::patch {
+		return a.diff(b);
+	}
+
+	// applies a patch made by diff (see graph::apply)
+	template<typename N, typename E>
+	auto apply(graph<N, E>& g, typename graph<N, E>::patch const& p) -> void {
+		g.apply(p);
+	}
+
 } // namespace gdwg
 
 #endif // GDWG_GRAPH_HPP
@@ -0,0 +1,85 @@
+#ifndef GDWG_MEMORY_HPP
+#define GDWG_MEMORY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gdwg {
+
+	// Heap memory owned by a node or weight value, beyond sizeof(T), for graph::memory_usage.
+	// Values that own nothing on the heap report 0, which is the default; std::string and
+	// std::vector are counted by capacity. Specialise heap_bytes<T> for any other type that owns
+	// heap memory.
+	template<typename T>
+	struct heap_bytes {
+		[[nodiscard]] static auto of(T const&) noexcept -> std::size_t {
+			return 0;
+		}
+	};
+
+	template<typename Char, typename Traits, typename Allocator>
+	struct heap_bytes<std::basic_string<Char, Traits, Allocator>> {
+		using string = std::basic_string<Char, Traits, Allocator>;
+		[[nodiscard]] static auto of(string const& value) noexcept -> std::size_t {
+			// a short string is kept inside the object itself (the small string optimisation)
+			auto const* const data = reinterpret_cast<char const*>(value.data());
+			auto const* const self = reinterpret_cast<char const*>(&value);
+			auto const less = std::less<char const*>{};
+			if (!less(data, self) and less(data, self + sizeof(string))) {
+				return 0;
+			}
+			return (value.capacity() + 1) * sizeof(Char);
+		}
+	};
+
+	template<typename T, typename Allocator>
+	struct heap_bytes<std::vector<T, Allocator>> {
+		[[nodiscard]] static auto of(std::vector<T, Allocator> const& value) noexcept
+		   -> std::size_t {
+			auto bytes = value.capacity() * sizeof(T);
+			for (auto const& element : value) {
+				bytes += heap_bytes<T>::of(element);
+			}
+			return bytes;
+		}
+	};
+
+	// what a graph costs, in bytes, by what the memory is for (see graph::memory_usage). These are
+	// estimates from the layout of the standard library and absl containers (allocator overhead
+	// isn't counted), good for budgeting and for comparing graphs rather than as an exact figure.
+	struct memory_footprint {
+		std::size_t nodes = 0; // node objects, each with its shared_ptr control block
+		std::size_t edges = 0; // edge objects, each with its shared_ptr control block
+		std::size_t index = 0; // the search trees over nodes and edges, and the topological order
+		std::size_t change_log = 0; // changes retained by the change stream
+		std::size_t payload = 0; // heap memory owned by node values and weights (heap_bytes)
+
+		[[nodiscard]] auto total() const noexcept -> std::size_t {
+			return nodes + edges + index + change_log + payload;
+		}
+		[[nodiscard]] auto operator==(memory_footprint const& other) const -> bool = default;
+	};
+
+	namespace detail {
+		[[nodiscard]] constexpr auto align_up(std::size_t bytes, std::size_t alignment) noexcept
+		   -> std::size_t {
+			return (bytes + alignment - 1) / alignment * alignment;
+		}
+
+		// std::make_shared<T>: one allocation holding the control block (a vtable pointer and the
+		// two reference counts) followed by the T
+		template<typename T>
+		inline constexpr auto shared_allocation_bytes =
+		   align_up(sizeof(void*) + 2 * sizeof(int), alignof(T)) + sizeof(T);
+
+		// an element of the B-tree graph keeps its nodes and edges in (see detail::tree): its slot,
+		// plus its share of the empty slots in part-full tree nodes, about a quarter on average
+		template<typename T>
+		inline constexpr auto tree_slot_bytes = (4 * sizeof(T) + 2) / 3;
+	} // namespace detail
+
+} // namespace gdwg
+
+#endif // GDWG_MEMORY_HPP
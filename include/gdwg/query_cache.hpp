@@ -0,0 +1,162 @@
+#ifndef GDWG_QUERY_CACHE_HPP
+#define GDWG_QUERY_CACHE_HPP
+
+#include <absl/container/btree_map.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// what a graph's query cache has done since it was enabled (see graph::enable_query_cache)
+	struct query_cache_stats {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0; // results dropped to make room
+		std::uint64_t invalidations = 0; // results dropped because a modifier changed them
+		std::size_t size = 0; // results cached now, of both kinds
+		std::size_t capacity = 0; // of each kind
+
+		[[nodiscard]] auto hit_rate() const noexcept -> double {
+			auto const lookups = hits + misses;
+			return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+		}
+		[[nodiscard]] auto operator==(query_cache_stats const& other) const -> bool = default;
+	};
+
+	namespace detail {
+		// A map of at most capacity entries that evicts with the CLOCK algorithm: entries sit in a
+		// ring of slots, a hit only sets the entry's referenced bit, and to make room the hand sweeps
+		// the ring, clearing referenced bits, until it finds an entry that wasn't used since the
+		// last sweep. That approximates least recently used without moving anything on a hit. Keys
+		// are looked up in a B-tree, so they only need to be ordered (by Compare, which may be
+		// transparent).
+		template<typename Key, typename Value, typename Compare>
+		class clock_cache {
+		public:
+			explicit clock_cache(std::size_t capacity)
+			: capacity_{std::max(capacity, std::size_t{1})} {}
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return index_.size();
+			}
+			[[nodiscard]] auto capacity() const noexcept -> std::size_t {
+				return capacity_;
+			}
+
+			// the value cached for key, marked as used, or nullptr
+			template<typename K>
+			[[nodiscard]] auto find(K const& key) -> Value const* {
+				auto const it = index_.find(key);
+				if (it == index_.end()) {
+					return nullptr;
+				}
+				auto& s = slots_[it->second];
+				s.referenced = true;
+				return &s.value;
+			}
+
+			// caches value for key, replacing what was cached for it; returns true if an entry was
+			// evicted to make room
+			auto insert(Key key, Value value) -> bool {
+				if (auto const it = index_.find(key); it != index_.end()) {
+					slots_[it->second].value = std::move(value);
+					return false;
+				}
+				auto evicted = false;
+				auto slot = std::size_t{0};
+				if (!free_.empty()) {
+					slot = free_.back();
+					free_.pop_back();
+				}
+				else if (slots_.size() < capacity_) {
+					slot = slots_.size();
+					slots_.emplace_back();
+				}
+				else {
+					while (slots_[hand_].referenced) {
+						slots_[hand_].referenced = false;
+						hand_ = (hand_ + 1) % slots_.size();
+					}
+					slot = hand_;
+					hand_ = (hand_ + 1) % slots_.size();
+					index_.erase(slots_[slot].key);
+					evicted = true;
+				}
+				index_.emplace(key, slot);
+				slots_[slot] = entry{std::move(key), std::move(value), false, true};
+				return evicted;
+			}
+
+			// drops the entry for key; returns true if there was one
+			template<typename K>
+			auto erase(K const& key) -> bool {
+				auto const it = index_.find(key);
+				if (it == index_.end()) {
+					return false;
+				}
+				release(it->second);
+				index_.erase(it);
+				return true;
+			}
+
+			// drops every entry whose key satisfies pred; returns how many
+			template<typename Pred>
+			auto erase_if(Pred pred) -> std::size_t {
+				auto erased = std::size_t{0};
+				for (auto it = index_.begin(); it != index_.end();) {
+					if (pred(it->first)) {
+						release(it->second);
+						it = index_.erase(it);
+						++erased;
+					}
+					else {
+						++it;
+					}
+				}
+				return erased;
+			}
+
+			auto clear() -> void {
+				index_.clear();
+				slots_.clear();
+				free_.clear();
+				hand_ = 0;
+			}
+
+			// the entries, for memory accounting
+			template<typename F>
+			auto for_each(F f) const -> void {
+				for (auto const& s : slots_) {
+					if (s.used) {
+						f(s.key, s.value);
+					}
+				}
+			}
+
+		private:
+			struct entry {
+				Key key{};
+				Value value{};
+				bool referenced = false;
+				bool used = false;
+			};
+
+			auto release(std::size_t slot) -> void {
+				slots_[slot] = entry{};
+				free_.push_back(slot);
+			}
+
+			std::size_t capacity_;
+			std::vector<entry> slots_{};
+			std::vector<std::size_t> free_{}; // slots emptied by erase
+			std::size_t hand_ = 0;
+			absl::btree_map<Key, std::size_t, Compare> index_{};
+		};
+	} // namespace detail
+
+} // namespace gdwg
+
+#endif // GDWG_QUERY_CACHE_HPP
@@ -0,0 +1,54 @@
+#ifndef GDWG_SERIALIZER_HPP
+#define GDWG_SERIALIZER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace gdwg {
+
+	// Binary encoding of node and weight values for the write-ahead log and snapshots. Values are
+	// appended to out, and read back from the front of in, which is advanced past them (read
+	// returns false if in is too short). Trivially copyable types are copied byte for byte and
+	// std::string is length prefixed; specialise serializer<T> for anything else.
+	template<typename T>
+	struct serializer {
+		static_assert(std::is_trivially_copyable_v<T>,
+		              "specialise gdwg::serializer<T> for node and weight types that are not "
+		              "trivially copyable");
+
+		static auto write(std::string& out, T const& value) -> void {
+			out.append(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+		[[nodiscard]] static auto read(std::string_view& in, T& value) -> bool {
+			if (in.size() < sizeof(T)) {
+				return false;
+			}
+			std::memcpy(&value, in.data(), sizeof(T));
+			in.remove_prefix(sizeof(T));
+			return true;
+		}
+	};
+
+	template<>
+	struct serializer<std::string> {
+		static auto write(std::string& out, std::string const& value) -> void {
+			serializer<std::uint64_t>::write(out, value.size());
+			out.append(value);
+		}
+		[[nodiscard]] static auto read(std::string_view& in, std::string& value) -> bool {
+			auto size = std::uint64_t{0};
+			if (!serializer<std::uint64_t>::read(in, size) or in.size() < size) {
+				return false;
+			}
+			value.assign(in.substr(0, size));
+			in.remove_prefix(size);
+			return true;
+		}
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_SERIALIZER_HPP
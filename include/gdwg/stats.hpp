@@ -0,0 +1,335 @@
+#ifndef GDWG_STATS_HPP
+#define GDWG_STATS_HPP
+
+#include <absl/container/btree_set.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace gdwg {
+
+	// Instrumentation of gdwg::graph is compiled in only when GDWG_GRAPH_STATS is defined (the
+	// CMake option <project>_ENABLE_GRAPH_STATS), which must be the same in every translation
+	// unit. Without it the counters and hooks below are empty types and discarded branches,
+	// graph::stats() is all zeros and no trace sink is called.
+#ifdef GDWG_GRAPH_STATS
+	inline constexpr auto stats_enabled = true;
+#else
+	inline constexpr auto stats_enabled = false;
+#endif
+
+	// the public graph methods that are timed
+	enum class graph_method : std::uint8_t {
+		insert_node,
+		insert_edge,
+		replace_node,
+		merge_replace_node,
+		erase_node,
+		erase_edge,
+		clear,
+		apply,
+		is_node,
+		is_connected,
+		nodes,
+		weights,
+		find,
+		connections,
+		edges_from,
+		freeze,
+		diff,
+		for_each_edge,
+	};
+	inline constexpr auto graph_method_count = std::size_t{18};
+
+	[[nodiscard]] constexpr auto method_name(graph_method method) noexcept -> std::string_view {
+		constexpr auto names = std::array<std::string_view, graph_method_count>{
+		   "insert_node", "insert_edge", "replace_node", "merge_replace_node", "erase_node",
+		   "erase_edge",  "clear",       "apply",        "is_node",            "is_connected",
+		   "nodes",       "weights",     "find",         "connections",        "edges_from",
+		   "freeze",      "diff",        "for_each_edge"};
+		return names[static_cast<std::size_t>(method)];
+	}
+
+	// calls of one method by how long they took: count[b] is the number that took from 2^b ns up
+	// to (not including) 2^(b + 1) ns, with calls under 1 ns in bucket 0
+	struct latency_histogram {
+		static constexpr auto buckets = std::size_t{40};
+		std::array<std::uint64_t, buckets> count{};
+		std::uint64_t calls = 0;
+		std::chrono::nanoseconds total{0};
+
+		// the top of the bucket holding the q-th fraction of the calls (q in [0, 1]); an upper
+		// bound on that quantile, within a factor of two
+		[[nodiscard]] auto quantile(double q) const -> std::chrono::nanoseconds {
+			auto const wanted = static_cast<std::uint64_t>(q * static_cast<double>(calls));
+			auto seen = std::uint64_t{0};
+			for (auto b = std::size_t{0}; b < buckets; ++b) {
+				seen += count[b];
+				if (seen > wanted or seen == calls) {
+					return std::chrono::nanoseconds{std::int64_t{1} << (b + 1)};
+				}
+			}
+			return std::chrono::nanoseconds{std::int64_t{1} << buckets};
+		}
+	};
+
+	// what a graph has done since it was made (see graph::stats)
+	struct graph_stats {
+		std::uint64_t node_comparisons = 0; // node_comparator calls
+		std::uint64_t edge_comparisons = 0; // edge_comparator calls
+		std::uint64_t tree_searches = 0; // finds, range lookups and inserts on the node or edge set
+		std::uint64_t allocations = 0; // make_shared calls plus B-tree nodes allocated
+		std::uint64_t make_shared_calls = 0;
+		std::uint64_t node_value_copies = 0; // copies of N into nodes, edges and results
+		std::uint64_t weight_copies = 0; // copies of E into edges and results
+		std::array<latency_histogram, graph_method_count> latency{};
+
+		[[nodiscard]] auto operator[](graph_method method) const -> latency_histogram const& {
+			return latency[static_cast<std::size_t>(method)];
+		}
+	};
+
+	// one completed call of a public method, for a trace sink
+	struct trace_event {
+		graph_method method;
+		std::chrono::nanoseconds duration;
+	};
+
+	// called once for every outermost public method call (one made from inside another method
+	// of the same graph is part of the outer call). A graph used from several threads at once
+	// calls it from all of them.
+	using trace_sink = std::function<void(trace_event const&)>;
+
+	namespace detail {
+		enum class counter : std::uint8_t {
+			node_comparisons,
+			edge_comparisons,
+			tree_searches,
+			allocations,
+			make_shared_calls,
+			node_value_copies,
+			weight_copies,
+		};
+		inline constexpr auto counter_count = std::size_t{7};
+
+		// the live counters of one graph; an empty type when instrumentation is compiled out.
+		// Copies start from zero, with no sink.
+		template<bool Enabled>
+		struct graph_counters {
+			[[nodiscard]] auto snapshot() const -> graph_stats {
+				return {};
+			}
+			auto set_sink(trace_sink const&) -> void {}
+		};
+
+		template<>
+		struct graph_counters<true> {
+			graph_counters() = default;
+			graph_counters(graph_counters const&) noexcept {}
+			auto operator=(graph_counters const&) noexcept -> graph_counters& {
+				return *this;
+			}
+
+			auto set_sink(trace_sink s) -> void {
+				sink = std::move(s);
+			}
+
+			auto add(counter c, std::uint64_t n) noexcept -> void {
+				counters[static_cast<std::size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+			}
+
+			auto record(graph_method method, std::chrono::nanoseconds duration) -> void {
+				auto& h = histograms[static_cast<std::size_t>(method)];
+				auto const ns = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+				auto const bucket = std::min<std::size_t>(ns == 0 ? 0 : std::bit_width(ns) - 1,
+				                                          latency_histogram::buckets - 1);
+				h.count[bucket].fetch_add(1, std::memory_order_relaxed);
+				h.calls.fetch_add(1, std::memory_order_relaxed);
+				h.total.fetch_add(ns, std::memory_order_relaxed);
+				if (sink) {
+					sink(trace_event{method, duration});
+				}
+			}
+
+			[[nodiscard]] auto snapshot() const -> graph_stats {
+				auto const get = [this](counter c) {
+					return counters[static_cast<std::size_t>(c)].load(std::memory_order_relaxed);
+				};
+				auto result = graph_stats{get(counter::node_comparisons),
+				                          get(counter::edge_comparisons),
+				                          get(counter::tree_searches),
+				                          get(counter::allocations),
+				                          get(counter::make_shared_calls),
+				                          get(counter::node_value_copies),
+				                          get(counter::weight_copies),
+				                          {}};
+				for (auto m = std::size_t{0}; m < graph_method_count; ++m) {
+					auto const& from = histograms[m];
+					auto& to = result.latency[m];
+					for (auto b = std::size_t{0}; b < latency_histogram::buckets; ++b) {
+						to.count[b] = from.count[b].load(std::memory_order_relaxed);
+					}
+					to.calls = from.calls.load(std::memory_order_relaxed);
+					to.total = std::chrono::nanoseconds{
+					   static_cast<std::int64_t>(from.total.load(std::memory_order_relaxed))};
+				}
+				return result;
+			}
+
+			struct histogram {
+				std::array<std::atomic<std::uint64_t>, latency_histogram::buckets> count{};
+				std::atomic<std::uint64_t> calls{0};
+				std::atomic<std::uint64_t> total{0};
+			};
+
+			std::array<std::atomic<std::uint64_t>, counter_count> counters{};
+			std::array<histogram, graph_method_count> histograms{};
+			trace_sink sink{};
+		};
+
+		// the counters of the graph whose method this thread is running, if any. Work a method
+		// hands to the thread pool isn't counted.
+		inline thread_local graph_counters<true>* active_counters = nullptr;
+
+		inline auto count(counter c, std::uint64_t n = 1) noexcept -> void {
+			if constexpr (stats_enabled) {
+				if (active_counters != nullptr) {
+					active_counters->add(c, n);
+				}
+			}
+		}
+
+		// makes a graph's counters the active ones for the length of a public method, and times
+		// the method when it's the outermost one running on that graph
+		template<bool Enabled>
+		class method_scope {
+		public:
+			constexpr method_scope(graph_counters<Enabled>&, graph_method) noexcept {}
+			// user-provided (but empty) so an unused scope variable isn't warned about
+			~method_scope() {} // NOLINT(modernize-use-equals-default)
+		};
+
+		template<>
+		class method_scope<true> {
+		public:
+			method_scope(graph_counters<true>& counters, graph_method method) noexcept
+			: counters_{counters}
+			, previous_{active_counters}
+			, method_{method} {
+				if (previous_ != &counters_) {
+					start_ = std::chrono::steady_clock::now();
+				}
+				active_counters = &counters_;
+			}
+
+			method_scope(method_scope const&) = delete;
+			auto operator=(method_scope const&) -> method_scope& = delete;
+
+			~method_scope() {
+				active_counters = previous_;
+				if (previous_ != &counters_) {
+					counters_.record(method_, std::chrono::steady_clock::now() - start_);
+				}
+			}
+
+		private:
+			graph_counters<true>& counters_;
+			graph_counters<true>* previous_;
+			graph_method method_;
+			std::chrono::steady_clock::time_point start_{};
+		};
+
+		// std::allocator, counting allocations
+		template<typename T>
+		struct counting_allocator {
+			using value_type = T;
+
+			counting_allocator() = default;
+			template<typename U>
+			// NOLINTNEXTLINE(google-explicit-constructor)
+			counting_allocator(counting_allocator<U> const&) noexcept {}
+
+			[[nodiscard]] auto allocate(std::size_t n) -> T* {
+				count(counter::allocations);
+				return std::allocator<T>{}.allocate(n);
+			}
+			auto deallocate(T* p, std::size_t n) noexcept -> void {
+				std::allocator<T>{}.deallocate(p, n);
+			}
+			template<typename U>
+			[[nodiscard]] auto operator==(counting_allocator<U> const&) const noexcept -> bool {
+				return true;
+			}
+		};
+
+		// absl::btree_set, counting searches and the tree nodes it allocates
+		template<typename T, typename Compare>
+		class counted_tree : public absl::btree_set<T, Compare, counting_allocator<T>> {
+			using base = absl::btree_set<T, Compare, counting_allocator<T>>;
+
+		public:
+			using base::base;
+
+			template<typename K>
+			[[nodiscard]] auto find(K const& key) const {
+				count(counter::tree_searches);
+				return base::find(key);
+			}
+			template<typename K>
+			[[nodiscard]] auto equal_range(K const& key) const {
+				count(counter::tree_searches);
+				return base::equal_range(key);
+			}
+			template<typename K>
+			[[nodiscard]] auto lower_bound(K const& key) const {
+				count(counter::tree_searches);
+				return base::lower_bound(key);
+			}
+			template<typename K>
+			[[nodiscard]] auto upper_bound(K const& key) const {
+				count(counter::tree_searches);
+				return base::upper_bound(key);
+			}
+			template<typename K>
+			[[nodiscard]] auto contains(K const& key) const -> bool {
+				count(counter::tree_searches);
+				return base::contains(key);
+			}
+
+			template<typename... Args>
+			auto emplace(Args&&... args) {
+				count(counter::tree_searches);
+				return base::emplace(std::forward<Args>(args)...);
+			}
+			template<typename... Args>
+			auto emplace_hint(typename base::const_iterator hint, Args&&... args) {
+				count(counter::tree_searches);
+				return base::emplace_hint(hint, std::forward<Args>(args)...);
+			}
+			template<typename V>
+			auto insert(V&& value) {
+				count(counter::tree_searches);
+				return base::insert(std::forward<V>(value));
+			}
+		};
+
+		// the ordered set graph stores its nodes and edges in: a B-tree, which keeps many elements
+		// to a node, so a search touches a few cache lines per level rather than one node per
+		// comparison, and a scan walks contiguous slots
+		template<typename T, typename Compare>
+		using tree =
+		   std::conditional_t<stats_enabled, counted_tree<T, Compare>, absl::btree_set<T, Compare>>;
+	} // namespace detail
+
+} // namespace gdwg
+
+#endif // GDWG_STATS_HPP
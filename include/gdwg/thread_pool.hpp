@@ -0,0 +1,259 @@
+#ifndef GDWG_THREAD_POOL_HPP
+#define GDWG_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+
+	//   =================
+	//   THREAD POOL CLASS
+	//   -----------------
+	//
+	// A small work-stealing pool. Each worker owns a deque of range tasks: it takes work from the
+	// back of its own deque and, when that is empty, steals from the front of the others. A range
+	// that is bigger than the grain size is split in half before it is run, and the upper half is
+	// pushed onto the running thread's deque, so idle workers always find large pieces to steal.
+	// The thread that calls parallel_for helps run tasks until its job is finished, which also
+	// makes nested calls from inside a task safe.
+	class thread_pool {
+	public:
+		explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency())
+		: queues_(std::max(std::size_t{1}, threads)) {
+			workers_.reserve(queues_.size());
+			for (auto i = std::size_t{0}; i < queues_.size(); ++i) {
+				workers_.emplace_back([this, i] { worker_loop(i); });
+			}
+		}
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		auto operator=(thread_pool const&) -> thread_pool& = delete;
+		auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+		~thread_pool() {
+			{
+				auto const lock = std::scoped_lock(sleep_mutex_);
+				stop_ = true;
+			}
+			sleep_cv_.notify_all();
+			for (auto& worker : workers_) {
+				worker.join();
+			}
+		}
+
+		// the pool shared by the library (bulk construction, algorithms), started on first use
+		[[nodiscard]] static auto shared() -> thread_pool& {
+			static auto pool = thread_pool();
+			return pool;
+		}
+
+		// number of worker threads
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return workers_.size();
+		}
+
+		// calls f(first, last) on disjoint sub-ranges covering [0, n), never splitting a range
+		// below grain elements (0 picks a grain giving each worker about eight pieces). Blocks
+		// until every sub-range has run; the first exception thrown by f is rethrown here and the
+		// sub-ranges that have not started yet are skipped.
+		template<typename F>
+		auto parallel_for(std::size_t n, F&& f, std::size_t grain = 0) -> void {
+			if (n == 0) {
+				return;
+			}
+			if (grain == 0) {
+				grain = std::max(std::size_t{1}, n / (8 * size()));
+			}
+			auto j = job{};
+			j.body = [](void const* fn, std::size_t first, std::size_t last) {
+				(*static_cast<std::remove_reference_t<F> const*>(fn))(first, last);
+			};
+			j.fn = std::addressof(f);
+			j.grain = grain;
+			j.remaining.store(n);
+			push(task{&j, 0, n});
+			while (j.remaining.load() != 0) {
+				if (!run_one()) {
+					auto lock = std::unique_lock(j.mutex);
+					j.done.wait_for(lock, std::chrono::microseconds(100), [&j] {
+						return j.remaining.load() == 0;
+					});
+				}
+			}
+			// the last task finishes under j.mutex; taking it here keeps j alive until it is done
+			auto const lock = std::scoped_lock(j.mutex);
+			if (j.error) {
+				std::rethrow_exception(j.error);
+			}
+		}
+
+	private:
+		struct job {
+			void (*body)(void const*, std::size_t, std::size_t) = nullptr;
+			void const* fn = nullptr;
+			std::size_t grain = 1;
+			std::atomic<std::size_t> remaining{0}; // elements not yet run (or skipped)
+			std::atomic<bool> failed{false};
+			std::exception_ptr error;
+			std::mutex mutex;
+			std::condition_variable done;
+		};
+		struct task {
+			job* owner;
+			std::size_t first;
+			std::size_t last;
+		};
+		struct queue {
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		// the queue owned by the calling thread, or none if it is not one of this pool's workers
+		[[nodiscard]] auto own_queue() const noexcept -> std::optional<std::size_t> {
+			if (current_pool_ == this) {
+				return current_queue_;
+			}
+			return std::nullopt;
+		}
+
+		auto push(task t) -> void {
+			auto const i = own_queue().value_or(next_queue_++ % queues_.size());
+			{
+				// counted before it is visible, so pending_ never drops below the real task count
+				auto const lock = std::scoped_lock(sleep_mutex_);
+				++pending_;
+			}
+			{
+				auto const lock = std::scoped_lock(queues_[i].mutex);
+				queues_[i].tasks.push_back(t);
+			}
+			sleep_cv_.notify_one();
+		}
+
+		// takes from the back of the caller's own deque, otherwise steals from the front of another
+		[[nodiscard]] auto pop() -> std::optional<task> {
+			auto const own = own_queue();
+			auto const start = own.value_or(0);
+			for (auto k = std::size_t{0}; k < queues_.size(); ++k) {
+				auto& q = queues_[(start + k) % queues_.size()];
+				auto const lock = std::scoped_lock(q.mutex);
+				if (q.tasks.empty()) {
+					continue;
+				}
+				auto t = task{};
+				if (own and k == 0) {
+					t = q.tasks.back();
+					q.tasks.pop_back();
+				}
+				else {
+					t = q.tasks.front();
+					q.tasks.pop_front();
+				}
+				pending_.fetch_sub(1);
+				return t;
+			}
+			return std::nullopt;
+		}
+
+		auto run_one() -> bool {
+			auto t = pop();
+			if (!t) {
+				return false;
+			}
+			run(*t);
+			return true;
+		}
+
+		auto run(task t) -> void {
+			auto& j = *t.owner;
+			while (t.last - t.first > j.grain) {
+				auto const mid = t.first + (t.last - t.first) / 2;
+				push(task{t.owner, mid, t.last});
+				t.last = mid;
+			}
+			if (!j.failed.load()) {
+				try {
+					j.body(j.fn, t.first, t.last);
+				} catch (...) {
+					if (!j.failed.exchange(true)) {
+						j.error = std::current_exception();
+					}
+				}
+			}
+			auto const lock = std::scoped_lock(j.mutex);
+			if (j.remaining.fetch_sub(t.last - t.first) == t.last - t.first) {
+				j.done.notify_all();
+			}
+		}
+
+		auto worker_loop(std::size_t i) -> void {
+			current_pool_ = this;
+			current_queue_ = i;
+			while (true) {
+				if (run_one()) {
+					continue;
+				}
+				auto lock = std::unique_lock(sleep_mutex_);
+				sleep_cv_.wait(lock, [this] { return stop_ or pending_.load() != 0; });
+				if (stop_) {
+					return;
+				}
+			}
+		}
+
+		static inline thread_local thread_pool const* current_pool_ = nullptr;
+		static inline thread_local std::size_t current_queue_ = 0;
+
+		std::vector<queue> queues_;
+		std::vector<std::thread> workers_;
+		std::atomic<std::size_t> next_queue_{0};
+		std::atomic<std::size_t> pending_{0}; // tasks sitting in any deque
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_cv_;
+		bool stop_ = false;
+	};
+
+	// ====================================
+	// PARALLEL TRAVERSALS (over any graph)
+	// ------------------------------------
+
+	// calls f(n) for every node of g, spread over the pool
+	template<typename G, typename F>
+	auto parallel_for_each_node(thread_pool& pool, G const& g, F f) -> void {
+		auto const nodes = g.nodes();
+		pool.parallel_for(nodes.size(), [&](std::size_t first, std::size_t last) {
+			for (; first != last; ++first) {
+				f(nodes[first]);
+			}
+		});
+	}
+
+	// calls f(e) for every edge of g (as a G::value_type), spread over the pool
+	template<typename G, typename F>
+	auto parallel_for_each_edge(thread_pool& pool, G const& g, F f) -> void {
+		auto edges = std::vector<typename G::value_type>{};
+		for (auto const& [from, to, weight] : g) {
+			edges.push_back(typename G::value_type{from, to, weight});
+		}
+		pool.parallel_for(edges.size(), [&](std::size_t first, std::size_t last) {
+			for (; first != last; ++first) {
+				f(edges[first]);
+			}
+		});
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_THREAD_POOL_HPP
@@ -0,0 +1,239 @@
+#ifndef GDWG_VIEWS_HPP
+#define GDWG_VIEWS_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	//   ===================
+	//   INDUCED VIEW CLASS
+	//   -------------------
+	//
+	// The subgraph of a graph induced by a set of its nodes: those nodes, and every edge whose
+	// ends are both among them. Nothing is copied; the view keeps a sorted list of its nodes and
+	// filters the parent's edges as they are asked for, so it costs O(k) to build for k nodes and
+	// each edge of the parent that is looked at costs one O(log k) membership test.
+	//
+	// The node set is fixed when the view is made (values that aren't nodes of the parent are
+	// left out), but edges are read from the parent each time, so the view sees edges inserted or
+	// erased since. Nodes erased from the parent since have no edges in the view. The parent must
+	// outlive the view. materialize() copies the view into a graph of its own.
+	template<typename N, typename E>
+	class induced_view {
+	public:
+		class iterator;
+		using value_type = typename graph<N, E>::value_type;
+
+		induced_view(graph<N, E> const& parent, std::vector<N> nodes)
+		: parent_{&parent}
+		, nodes_{std::move(nodes)} {
+			std::sort(nodes_.begin(), nodes_.end());
+			nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+			std::erase_if(nodes_, [&](N const& n) { return !parent.is_node(n); });
+		}
+
+		[[nodiscard]] auto parent() const noexcept -> graph<N, E> const& {
+			return *parent_;
+		}
+
+		// =========
+		// ACCESSORS
+		// ---------
+		// as in graph, each only sees what's inside the view
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return std::binary_search(nodes_.begin(), nodes_.end(), value);
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+
+		[[nodiscard]] auto nodes() const -> std::vector<N> const& {
+			return nodes_;
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			if (!is_node(src) or !is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::induced_view<N, E>::is_connected if src or "
+				                         "dst node don't exist in the view");
+			}
+			return parent_->is_node(src) and parent_->is_node(dst)
+			       and parent_->is_connected(src, dst);
+		}
+
+		[[nodiscard]] auto weights(N const& from, N const& to) const -> std::vector<E> {
+			if (!is_node(from) or !is_node(to)) {
+				throw std::runtime_error("Cannot call gdwg::induced_view<N, E>::weights if src or dst "
+				                         "node don't exist in the view");
+			}
+			if (!parent_->is_node(from) or !parent_->is_node(to)) {
+				return {};
+			}
+			return parent_->weights(from, to);
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			if (!is_node(src)) {
+				throw std::runtime_error("Cannot call gdwg::induced_view<N, E>::connections if src "
+				                         "doesn't exist in the view");
+			}
+			auto connections = std::vector<N>{};
+			if (!parent_->is_node(src)) {
+				return connections;
+			}
+			auto [first, last] = parent_->edges_from(src);
+			for (; first != last; ++first) {
+				auto const& to = std::get<1>(*first);
+				if (is_node(to)) {
+					connections.push_back(to);
+				}
+			}
+			return connections;
+		}
+
+		// copies the view into a new graph: its nodes, and the edges between them
+		[[nodiscard]] auto materialize() const -> graph<N, E> {
+			auto edges = std::vector<value_type>{};
+			for (auto const& [from, to, weight] : *this) {
+				edges.push_back(value_type{from, to, weight});
+			}
+			auto g = graph<N, E>(edges.begin(), edges.end());
+			for (auto const& n : nodes_) {
+				g.insert_node(n); // the ones without edges
+			}
+			return g;
+		}
+
+		// ============
+		// RANGE ACCESS
+		// ------------
+		// the edges of the view, in the parent's edge order
+		[[nodiscard]] auto begin() const -> iterator {
+			return iterator(this, 0);
+		}
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator(this, nodes_.size());
+		}
+
+	private:
+		graph<N, E> const* parent_;
+		std::vector<N> nodes_;
+	};
+
+	//   ==============
+	//   ITERATOR CLASS
+	//   --------------
+	// Walks the parent's edges from each node of the view in turn, skipping those that leave it.
+	template<typename N, typename E>
+	class induced_view<N, E>::iterator {
+	public:
+		using value_type = typename std::iterator_traits<typename graph<N, E>::iterator>::value_type;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+
+		iterator() = default;
+
+		auto operator*() const {
+			return *edge_;
+		}
+
+		auto operator++() -> iterator& {
+			++edge_;
+			settle();
+			return *this;
+		}
+
+		auto operator++(int) -> iterator {
+			auto temp = *this;
+			++*this;
+			return temp;
+		}
+
+		auto operator==(iterator const& other) const -> bool {
+			return node_ == other.node_ and (node_ == view_->nodes_.size() or edge_ == other.edge_);
+		}
+
+	private:
+		friend class induced_view<N, E>;
+
+		iterator(induced_view const* view, std::size_t node)
+		: view_{view}
+		, node_{node} {
+			if (node_ < view_->nodes_.size()) {
+				enter();
+				settle();
+			}
+		}
+
+		// starts on the edges from the current node
+		auto enter() -> void {
+			auto const& parent = *view_->parent_;
+			auto const& n = view_->nodes_[node_];
+			if (parent.is_node(n)) {
+				std::tie(edge_, last_) = parent.edges_from(n);
+			}
+			else {
+				edge_ = last_ = parent.end();
+			}
+		}
+
+		// moves forward to the next edge inside the view, or to end()
+		auto settle() -> void {
+			while (true) {
+				while (edge_ != last_) {
+					if (view_->is_node(std::get<1>(*edge_))) {
+						return;
+					}
+					++edge_;
+				}
+				if (++node_ == view_->nodes_.size()) {
+					return;
+				}
+				enter();
+			}
+		}
+
+		induced_view const* view_ = nullptr;
+		std::size_t node_ = 0;
+		typename graph<N, E>::iterator edge_{};
+		typename graph<N, E>::iterator last_{};
+	};
+
+	// the nodes reachable from n by following at most k edges (in their direction), with the
+	// edges among them. Throws if n isn't a node of g.
+	template<typename N, typename E>
+	[[nodiscard]] auto ego_view(graph<N, E> const& g, N const& n, std::size_t k)
+	   -> induced_view<N, E> {
+		if (!g.is_node(n)) {
+			throw std::runtime_error("Cannot call gdwg::ego_view if n doesn't exist in the graph");
+		}
+		auto reached = std::set<N>{n};
+		auto frontier = std::vector<N>{n};
+		for (auto hop = std::size_t{0}; hop < k and !frontier.empty(); ++hop) {
+			auto next = std::vector<N>{};
+			for (auto const& from : frontier) {
+				auto [first, last] = g.edges_from(from);
+				for (; first != last; ++first) {
+					auto const& to = std::get<1>(*first);
+					if (reached.insert(to).second) {
+						next.push_back(to);
+					}
+				}
+			}
+			frontier = std::move(next);
+		}
+		return induced_view<N, E>(g, std::vector<N>(reached.begin(), reached.end()));
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_VIEWS_HPP
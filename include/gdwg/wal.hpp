@@ -0,0 +1,308 @@
+#ifndef GDWG_WAL_HPP
+#define GDWG_WAL_HPP
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace gdwg {
+
+	namespace detail {
+		inline constexpr auto crc32_table = [] {
+			auto table = std::array<std::uint32_t, 256>{};
+			for (auto i = std::uint32_t{0}; i < 256; ++i) {
+				auto c = i;
+				for (auto k = 0; k < 8; ++k) {
+					c = (c & 1U) != 0 ? 0xEDB88320U ^ (c >> 1U) : c >> 1U;
+				}
+				table[i] = c;
+			}
+			return table;
+		}();
+
+		// CRC-32 (as used by zlib); crc32(b, crc32(a)) == crc32(a + b)
+		[[nodiscard]] inline auto crc32(std::string_view data, std::uint32_t crc = 0) noexcept
+		   -> std::uint32_t {
+			crc = ~crc;
+			for (auto const c : data) {
+				crc = crc32_table[(crc ^ static_cast<unsigned char>(c)) & 0xFFU] ^ (crc >> 8U);
+			}
+			return ~crc;
+		}
+
+		[[noreturn]] inline auto throw_errno(std::string const& what) -> void {
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		// writes all of data to fd, retrying short and interrupted writes
+		inline auto write_all(int fd, std::string_view data) -> void {
+			while (!data.empty()) {
+				auto const written = ::write(fd, data.data(), data.size());
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw_errno("Cannot write to the write-ahead log");
+				}
+				data.remove_prefix(static_cast<std::size_t>(written));
+			}
+		}
+
+		// makes a rename or newly created file in dir durable
+		inline auto sync_directory(std::filesystem::path const& dir) -> void {
+			auto const fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+			if (fd < 0) {
+				throw_errno("Cannot open " + dir.string());
+			}
+			auto const result = ::fsync(fd);
+			::close(fd);
+			if (result != 0) {
+				throw_errno("Cannot sync " + dir.string());
+			}
+		}
+	} // namespace detail
+
+	struct wal_options {
+		// a group of records is written (and synced) as soon as this many are waiting, or ...
+		std::size_t group_size = 512;
+		// ... once the first of them has waited this long
+		std::chrono::microseconds group_delay{2000};
+		// fsync each group; without it the log survives the process crashing but not the machine
+		bool sync = true;
+		// append() blocks while this many bytes are waiting to be written
+		std::size_t max_buffered_bytes = std::size_t{64} << 20U;
+	};
+
+	// one record as read back from a log
+	struct wal_record {
+		std::uint64_t lsn = 0;
+		std::uint8_t type = 0;
+		std::string payload{};
+	};
+
+	//   =======================
+	//   WRITE-AHEAD LOG CLASS
+	//   -----------------------
+	//
+	// An append-only file of checksummed records, each numbered with a log sequence number (lsn)
+	// one higher than the last. append() only copies the record into a buffer; a background thread
+	// writes the buffer out and fsyncs it once per group of records (group commit), so many
+	// records share the cost of one sync. commit() waits until everything appended so far is on
+	// disk. A crash can leave a torn record at the end of the file, which replay() cuts off.
+	//
+	// Record layout (native byte order): u32 payload size, u32 CRC-32 of the rest, u64 lsn,
+	// u8 type, payload.
+	class write_ahead_log {
+	public:
+		// opens (or creates) the log at path for appending; the next record gets lsn next_lsn
+		write_ahead_log(std::filesystem::path const& path,
+		                std::uint64_t next_lsn,
+		                wal_options const& opts = {})
+		: opts_{opts}
+		, last_lsn_{next_lsn - 1}
+		, durable_lsn_{next_lsn - 1} {
+			fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+			if (fd_ < 0) {
+				detail::throw_errno("Cannot open the write-ahead log " + path.string());
+			}
+			detail::sync_directory(path.has_parent_path() ? path.parent_path() : ".");
+			writer_ = std::thread([this] { run(); });
+		}
+
+		write_ahead_log(write_ahead_log const&) = delete;
+		write_ahead_log(write_ahead_log&&) = delete;
+		auto operator=(write_ahead_log const&) -> write_ahead_log& = delete;
+		auto operator=(write_ahead_log&&) -> write_ahead_log& = delete;
+
+		// writes out whatever is still buffered; errors are lost here, call commit() to see them
+		~write_ahead_log() {
+			{
+				auto const lock = std::scoped_lock(mutex_);
+				stopping_ = true;
+			}
+			wake_.notify_one();
+			writer_.join();
+			::close(fd_);
+		}
+
+		// buffers one record and returns its lsn. Rethrows the error of an earlier failed write,
+		// after which the log can't be used any more.
+		auto append(std::uint8_t type, std::string_view payload) -> std::uint64_t {
+			auto lock = std::unique_lock(mutex_);
+			written_.wait(lock, [this] {
+				return error_ or buffer_.size() < opts_.max_buffered_bytes;
+			});
+			if (error_) {
+				std::rethrow_exception(error_);
+			}
+			auto const lsn = ++last_lsn_;
+			auto body = std::string{};
+			body.reserve(sizeof(lsn) + sizeof(type) + payload.size());
+			body.append(reinterpret_cast<char const*>(&lsn), sizeof(lsn));
+			body.append(reinterpret_cast<char const*>(&type), sizeof(type));
+			body.append(payload);
+			auto const size = static_cast<std::uint32_t>(payload.size());
+			auto const crc = detail::crc32(body);
+			buffer_.append(reinterpret_cast<char const*>(&size), sizeof(size));
+			buffer_.append(reinterpret_cast<char const*>(&crc), sizeof(crc));
+			buffer_.append(body);
+			if (++buffered_records_ == 1 or buffered_records_ >= opts_.group_size) {
+				wake_.notify_one();
+			}
+			return lsn;
+		}
+
+		// blocks until every record appended so far is written (and synced, if opts.sync)
+		auto commit() -> void {
+			auto lock = std::unique_lock(mutex_);
+			auto const target = last_lsn_;
+			++committers_;
+			wake_.notify_one();
+			written_.wait(lock, [&] { return error_ or durable_lsn_ >= target; });
+			--committers_;
+			if (error_) {
+				std::rethrow_exception(error_);
+			}
+		}
+
+		// commits, then empties the file; for once a snapshot has made every record redundant.
+		// Record numbering carries on from where it was.
+		auto reset() -> void {
+			commit();
+			auto const lock = std::scoped_lock(mutex_);
+			if (::ftruncate(fd_, 0) != 0 or (opts_.sync and ::fsync(fd_) != 0)) {
+				detail::throw_errno("Cannot truncate the write-ahead log");
+			}
+		}
+
+		[[nodiscard]] auto last_lsn() const -> std::uint64_t {
+			auto const lock = std::scoped_lock(mutex_);
+			return last_lsn_;
+		}
+		[[nodiscard]] auto durable_lsn() const -> std::uint64_t {
+			auto const lock = std::scoped_lock(mutex_);
+			return durable_lsn_;
+		}
+
+		// calls f(record) for each intact record of the log at path, in order, and cuts off
+		// anything after the last one (a record torn by a crash, or garbage). Returns the number
+		// of records read; a missing file has none.
+		template<typename F>
+		static auto replay(std::filesystem::path const& path, F f) -> std::size_t {
+			auto in = std::ifstream(path, std::ios::binary);
+			if (!in) {
+				return 0;
+			}
+			auto const file_size = std::filesystem::file_size(path);
+			auto valid = std::uintmax_t{0};
+			auto records = std::size_t{0};
+			auto previous = std::uint64_t{0};
+			auto header = std::array<char, 2 * sizeof(std::uint32_t)>{};
+			auto body = std::string{};
+			while (in.read(header.data(), header.size())) {
+				auto size = std::uint32_t{0};
+				auto crc = std::uint32_t{0};
+				std::memcpy(&size, header.data(), sizeof(size));
+				std::memcpy(&crc, header.data() + sizeof(size), sizeof(crc));
+				auto const body_size = sizeof(std::uint64_t) + sizeof(std::uint8_t) + size;
+				if (body_size > file_size - valid - header.size()) {
+					break;
+				}
+				body.resize(body_size);
+				if (!in.read(body.data(), static_cast<std::streamsize>(body.size()))
+				    or detail::crc32(body) != crc)
+				{
+					break;
+				}
+				auto record = wal_record{};
+				std::memcpy(&record.lsn, body.data(), sizeof(record.lsn));
+				std::memcpy(&record.type, body.data() + sizeof(record.lsn), sizeof(record.type));
+				if (records != 0 and record.lsn <= previous) {
+					break;
+				}
+				record.payload = body.substr(sizeof(record.lsn) + sizeof(record.type));
+				previous = record.lsn;
+				f(std::move(record));
+				++records;
+				valid += header.size() + body_size;
+			}
+			in.close();
+			if (valid != file_size) {
+				std::filesystem::resize_file(path, valid);
+			}
+			return records;
+		}
+
+	private:
+		auto run() -> void {
+			auto lock = std::unique_lock(mutex_);
+			auto group = std::string{};
+			while (true) {
+				wake_.wait(lock, [this] { return stopping_ or !buffer_.empty(); });
+				if (buffer_.empty()) {
+					return; // stopping, and everything is written
+				}
+				// give the group a chance to fill up, unless someone is waiting on it
+				wake_.wait_for(lock, opts_.group_delay, [this] {
+					return stopping_ or committers_ != 0 or buffered_records_ >= opts_.group_size;
+				});
+				group.swap(buffer_);
+				buffer_.clear();
+				buffered_records_ = 0;
+				auto const lsn = last_lsn_;
+				lock.unlock();
+				written_.notify_all(); // the buffer has room again
+				auto error = std::exception_ptr{};
+				try {
+					detail::write_all(fd_, group);
+					if (opts_.sync and ::fdatasync(fd_) != 0) {
+						detail::throw_errno("Cannot sync the write-ahead log");
+					}
+				} catch (...) {
+					error = std::current_exception();
+				}
+				lock.lock();
+				if (error) {
+					error_ = error;
+				}
+				else {
+					durable_lsn_ = lsn;
+				}
+				written_.notify_all();
+			}
+		}
+
+		wal_options opts_;
+		int fd_ = -1;
+		mutable std::mutex mutex_{};
+		std::condition_variable wake_{}; // for the writer: records to write, or stopping
+		std::condition_variable written_{}; // for append and commit: a group was written
+		std::string buffer_{};
+		std::size_t buffered_records_ = 0;
+		std::size_t committers_ = 0;
+		std::uint64_t last_lsn_;
+		std::uint64_t durable_lsn_;
+		std::exception_ptr error_{};
+		bool stopping_ = false;
+		std::thread writer_{};
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_WAL_HPP
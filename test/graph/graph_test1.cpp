@@ -4,6 +4,7 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <initializer_list>
+#include <range/v3/algorithm/is_sorted.hpp>
 #include <sstream>
 
 // ================================
@@ -83,6 +84,25 @@ TEST_CASE("constructor 4 (range[first,last] - nodes and edges)") {
 		auto g1 = graph(v.begin(), v.end());
 		CHECK(g1.nodes().empty());
 	}
+	SECTION("large range (built in parallel) matches one inserted edge by edge") {
+		// big enough to be split across threads, with every edge repeated to test de-duplication
+		using graph = gdwg::graph<int, int>;
+		auto v = std::vector<graph::value_type>{};
+		for (auto i = 0; i < 100000; ++i) {
+			v.push_back({(i * 7919) % 5000, (i * 7 + 3) % 4999, i % 13});
+			v.push_back({(i * 7919) % 5000, (i * 7 + 3) % 4999, i % 13});
+		}
+		auto g1 = graph(v.begin(), v.end());
+		auto g2 = graph();
+		for (auto const& vt : v) {
+			g2.insert_node(vt.from);
+			g2.insert_node(vt.to);
+			g2.insert_edge(vt.from, vt.to, vt.weight);
+		}
+		CHECK(g1 == g2);
+		CHECK(g1.nodes() == g2.nodes());
+		CHECK(ranges::is_sorted(g1.nodes()));
+	}
 }
 
 TEST_CASE("Move constructor") {
@@ -168,6 +188,9 @@ TEST_CASE("Copy constructor") {
 		g1.insert_node(42); // check this only goes into g1
 		CHECK(g1.is_node(42));
 		CHECK(!g2.is_node(42));
+		g2.merge_replace_node(6, 3); // check the copy doesn't share nodes or edges with g1
+		CHECK(g1.is_node(6));
+		CHECK(g1.weights(6, 2) == std::vector<double>{5.55});
 	}
 	SECTION("check correct construction for empty list") {
 		using graph = gdwg::graph<std::string, std::string>;
@@ -0,0 +1,123 @@
+#include "gdwg/algorithms/pagerank.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ==========
+// PAGERANK
+// ----------
+
+namespace {
+	// the textbook dense power iteration, for comparing against
+	template<typename N, typename E>
+	auto reference_pagerank(gdwg::frozen_graph<N, E> const& g, double d, std::size_t iterations)
+	   -> std::vector<double> {
+		auto const n = g.size();
+		auto rank = std::vector<double>(n, 1.0 / static_cast<double>(n));
+		for (auto it = std::size_t{0}; it < iterations; ++it) {
+			auto next = std::vector<double>(n, (1.0 - d) / static_cast<double>(n));
+			for (auto from = gdwg::node_id{0}; from < n; ++from) {
+				auto const weights = g.out_weights(from);
+				auto const total = std::accumulate(weights.begin(), weights.end(), 0.0);
+				if (total == 0.0) {
+					for (auto& r : next) {
+						r += d * rank[from] / static_cast<double>(n);
+					}
+					continue;
+				}
+				auto const targets = g.out_edges(from);
+				for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+					next[targets[i]] += d * rank[from] * static_cast<double>(weights[i]) / total;
+				}
+			}
+			rank = next;
+		}
+		return rank;
+	}
+
+	auto sum(std::vector<double> const& v) -> double {
+		return std::accumulate(v.begin(), v.end(), 0.0);
+	}
+} // namespace
+
+TEST_CASE("pagerank") {
+	SECTION("a cycle ranks every node the same") {
+		using graph = gdwg::graph<int, int>;
+		auto const v = std::vector<graph::value_type>{{1, 2, 1}, {2, 3, 1}, {3, 1, 1}};
+		auto const r = gdwg::algorithms::pagerank(graph(v.begin(), v.end()));
+		CHECK(r.converged);
+		for (auto const x : r.rank) {
+			CHECK(x == Approx(1.0 / 3.0));
+		}
+	}
+	SECTION("dangling nodes keep the ranks summing to one") {
+		using graph = gdwg::graph<std::string, double>;
+		auto const v = std::vector<graph::value_type>{{"a", "sink", 1.0},
+		                                              {"b", "sink", 1.0},
+		                                              {"c", "a", 1.0}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("lonely");
+		auto const r = gdwg::algorithms::pagerank(g);
+		CHECK(sum(r.rank) == Approx(1.0));
+		auto const f = g.freeze();
+		CHECK(r.rank[f.id("sink")] > r.rank[f.id("a")]);
+		CHECK(r.rank[f.id("a")] > r.rank[f.id("b")]);
+		CHECK(r.rank[f.id("b")] == Approx(r.rank[f.id("lonely")]));
+	}
+	SECTION("weights are used only when asked for and E is arithmetic") {
+		using graph = gdwg::graph<char, int>;
+		auto const v =
+		   std::vector<graph::value_type>{{'a', 'b', 3}, {'a', 'c', 1}, {'b', 'a', 1}, {'c', 'a', 1}};
+		auto const f = graph(v.begin(), v.end()).freeze();
+		auto const weighted = gdwg::algorithms::pagerank(f);
+		CHECK(weighted.rank[1] > weighted.rank[2]);
+		auto const plain = gdwg::algorithms::pagerank(f, {.weighted = false});
+		CHECK(plain.rank[1] == Approx(plain.rank[2]));
+
+		using labelled = gdwg::graph<char, std::string>;
+		auto const w = std::vector<labelled::value_type>{{'a', 'b', "x"}, {'b', 'a', "y"}};
+		auto const r = gdwg::algorithms::pagerank(labelled(w.begin(), w.end()));
+		CHECK(r.rank[0] == Approx(0.5));
+	}
+	SECTION("matches a dense power iteration on a larger graph and a multi-threaded pool") {
+		using graph = gdwg::graph<int, double>;
+		auto v = std::vector<graph::value_type>{};
+		for (auto i = 0; i < 60000; ++i) {
+			// node 0 gets a large share of the edges, the high nodes have none going out
+			auto const from = i % 3 == 0 ? 0 : (i * 7919) % 4000;
+			v.push_back({from, (i * 10007) % 5000, static_cast<double>(i % 5)});
+		}
+		auto const f = graph(v.begin(), v.end()).freeze();
+		auto pool = gdwg::thread_pool(4);
+		auto const opts = gdwg::algorithms::pagerank_options{.tolerance = 0.0, .max_iterations = 30};
+		auto const r = gdwg::algorithms::pagerank(f, opts, pool);
+		CHECK(!r.converged);
+		CHECK(r.iterations == 30);
+		auto const expected = reference_pagerank(f, opts.damping, 30);
+		auto max_error = 0.0;
+		for (auto i = std::size_t{0}; i < f.size(); ++i) {
+			max_error = std::max(max_error, std::abs(r.rank[i] - expected[i]));
+		}
+		CHECK(max_error < 1e-12);
+		CHECK(sum(r.rank) == Approx(1.0));
+	}
+	SECTION("invalid options and weights") {
+		using graph = gdwg::graph<int, int>;
+		auto const v = std::vector<graph::value_type>{{1, 2, -1}};
+		auto const g = graph(v.begin(), v.end());
+		CHECK_THROWS_AS(gdwg::algorithms::pagerank(g, {.damping = 1.5}), std::invalid_argument);
+		CHECK_THROWS_WITH(gdwg::algorithms::pagerank(g),
+		                  "Cannot call gdwg::algorithms::pagerank with a negative edge weight");
+		CHECK(gdwg::algorithms::pagerank(g, {.weighted = false}).converged);
+	}
+	SECTION("empty graph") {
+		auto const r = gdwg::algorithms::pagerank(gdwg::graph<int, int>{});
+		CHECK(r.rank.empty());
+		CHECK(r.converged);
+	}
+}
@@ -0,0 +1,105 @@
+#include "gdwg/edge_list.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ===========================
+// STREAMING EDGE LIST INPUT
+// ---------------------------
+
+TEST_CASE("read_edge_list") {
+	SECTION("whitespace separated, with comments, blank lines and a last line without a newline") {
+		auto in = std::istringstream("# from to weight\n"
+		                             "1 2 0.5\n"
+		                             "\n"
+		                             "  2\t\t3   -1.25  \r\n"
+		                             "   # indented comment\n"
+		                             "3 1 1e3");
+		auto g = gdwg::graph<int, double>{};
+		CHECK(gdwg::read_edge_list(in, g) == 3);
+		CHECK(g.nodes() == std::vector<int>{1, 2, 3});
+		CHECK(g.weights(1, 2) == std::vector<double>{0.5});
+		CHECK(g.weights(2, 3) == std::vector<double>{-1.25});
+		CHECK(g.weights(3, 1) == std::vector<double>{1000.0});
+	}
+	SECTION("CSV with a header and string nodes, into a graph that already has edges") {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{{"sydney", "perth", 3290}};
+		auto g = graph(v.begin(), v.end());
+		auto in = std::istringstream("from,to,km\n"
+		                             "sydney , melbourne, 713\n"
+		                             "melbourne,adelaide,654\n"
+		                             "sydney,perth,3290\n");
+		auto const opts = gdwg::edge_list_options{.delimiter = ',', .skip_header = true};
+		CHECK(gdwg::read_edge_list(in, g, opts) == 3);
+		CHECK(g.nodes() == std::vector<std::string>{"adelaide", "melbourne", "perth", "sydney"});
+		CHECK(g.weights("sydney", "melbourne") == std::vector<int>{713});
+		CHECK(g.weights("sydney", "perth") == std::vector<int>{3290});
+	}
+	SECTION("lines split across chunks and lines longer than a chunk") {
+		auto text = std::string{};
+		auto expected = std::vector<gdwg::graph<int, int>::value_type>{};
+		for (auto i = 0; i < 5000; ++i) {
+			auto const from = (i * 7919) % 1000;
+			auto const to = (i * 10007) % 1013;
+			text += std::to_string(from) + "\t" + std::to_string(to) + "\t" + std::to_string(i % 17);
+			text += i % 100 == 0 ? std::string(300, ' ') + "\n" : "\n";
+			expected.push_back({from, to, i % 17});
+		}
+		auto in = std::istringstream(text);
+		auto g = gdwg::graph<int, int>{};
+		auto const opts = gdwg::edge_list_options{.delimiter = '\t', .chunk_size = 64};
+		CHECK(gdwg::read_edge_list(in, g, opts) == 5000);
+		CHECK(g == gdwg::graph<int, int>(expected.begin(), expected.end()));
+	}
+	SECTION("a bad line names its line number") {
+		auto const message = [](std::string const& text) {
+			auto in = std::istringstream(text);
+			auto g = gdwg::graph<int, int>{};
+			try {
+				gdwg::read_edge_list(in, g, {.chunk_size = 8});
+			} catch (std::runtime_error const& e) {
+				return std::string(e.what());
+			}
+			return std::string{};
+		};
+		CHECK(message("1 2 3\n# comment\n1 2\n")
+		      == "Cannot read the edge list: line 3 is not a valid \"from to weight\" edge");
+		CHECK(message("1 2 3\n4 5 x\n")
+		      == "Cannot read the edge list: line 2 is not a valid \"from to weight\" edge");
+		CHECK(message("1 2 3 4\n")
+		      == "Cannot read the edge list: line 1 is not a valid \"from to weight\" edge");
+		CHECK(message("1 2 3.5\n")
+		      == "Cannot read the edge list: line 1 is not a valid \"from to weight\" edge");
+		CHECK(message("1 2 3\n").empty());
+	}
+	SECTION("errors from the graph are passed on") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.enable_topological_order();
+		auto in = std::istringstream("1 2 0\n2 1 0\n");
+		CHECK_THROWS_WITH(gdwg::read_edge_list(in, g),
+		                  "Cannot call gdwg::graph<N, E>::insert_edge when the edge would create "
+		                  "a cycle in the topological order");
+		CHECK(g.is_connected(1, 2));
+		CHECK(!g.is_connected(2, 1));
+	}
+}
+
+TEST_CASE("load_edge_list") {
+	auto const path = std::filesystem::temp_directory_path() / "gdwg_graph_test11.tsv";
+	{
+		auto out = std::ofstream(path);
+		out << "a\tb\t1\nb\tc\t2\nc\ta\t3\n";
+	}
+	auto const g = gdwg::load_edge_list<char, int>(path, {.delimiter = '\t'});
+	CHECK(g.nodes() == std::vector<char>{'a', 'b', 'c'});
+	CHECK(g.connections('c') == std::vector<char>{'a'});
+	std::filesystem::remove(path);
+	CHECK_THROWS_AS((gdwg::load_edge_list<char, int>(path)), std::runtime_error);
+}
@@ -0,0 +1,170 @@
+#include "gdwg/durable_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/wal.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============================
+// WRITE-AHEAD LOG AND SNAPSHOTS
+// -----------------------------
+
+namespace {
+	// an empty directory of its own for each test, removed again afterwards
+	struct scratch_directory {
+		explicit scratch_directory(std::string const& name)
+		: path{std::filesystem::temp_directory_path() / ("gdwg_graph_test12_" + name)} {
+			std::filesystem::remove_all(path);
+		}
+		scratch_directory(scratch_directory const&) = delete;
+		auto operator=(scratch_directory const&) -> scratch_directory& = delete;
+		~scratch_directory() {
+			std::filesystem::remove_all(path);
+		}
+		std::filesystem::path path;
+	};
+
+	auto append_bytes(std::filesystem::path const& path, std::string const& bytes) -> void {
+		auto out = std::ofstream(path, std::ios::binary | std::ios::app);
+		out << bytes;
+	}
+} // namespace
+
+TEST_CASE("write_ahead_log") {
+	auto const dir = scratch_directory("log");
+	std::filesystem::create_directories(dir.path);
+	auto const path = dir.path / "wal";
+	{
+		auto log = gdwg::write_ahead_log(path, 1, {.group_size = 3});
+		for (auto i = 0; i < 10; ++i) {
+			auto const payload = std::string(static_cast<std::size_t>(i), 'x');
+			auto const lsn = log.append(static_cast<std::uint8_t>(i), payload);
+			CHECK(lsn == static_cast<std::uint64_t>(i + 1));
+		}
+		log.commit();
+		CHECK(log.durable_lsn() == 10);
+	}
+	SECTION("records come back in order") {
+		auto records = std::vector<gdwg::wal_record>{};
+		CHECK(gdwg::write_ahead_log::replay(path, [&](gdwg::wal_record r) { records.push_back(r); })
+		      == 10);
+		REQUIRE(records.size() == 10);
+		CHECK(records[4].lsn == 5);
+		CHECK(records[4].type == 4);
+		CHECK(records[4].payload == "xxxx");
+	}
+	SECTION("a torn or corrupt tail is cut off") {
+		auto const size = std::filesystem::file_size(path);
+		append_bytes(path, std::string("\x05\x00\x00\x00\x01\x02", 6)); // half a header
+		CHECK(gdwg::write_ahead_log::replay(path, [](gdwg::wal_record const&) {}) == 10);
+		CHECK(std::filesystem::file_size(path) == size);
+
+		std::filesystem::resize_file(path, size - 1); // the last record loses a byte
+		CHECK(gdwg::write_ahead_log::replay(path, [](gdwg::wal_record const&) {}) == 9);
+		auto log = gdwg::write_ahead_log(path, 10);
+		log.append(0, "again");
+		log.commit();
+		auto last = gdwg::wal_record{};
+		CHECK(gdwg::write_ahead_log::replay(path, [&](gdwg::wal_record r) { last = r; }) == 10);
+		CHECK(last.payload == "again");
+	}
+	SECTION("a missing log has no records") {
+		CHECK(gdwg::write_ahead_log::replay(dir.path / "none", [](gdwg::wal_record const&) {}) == 0);
+	}
+}
+
+TEST_CASE("durable_graph") {
+	using durable = gdwg::durable_graph<std::string, double>;
+	auto const dir = scratch_directory("graph");
+	auto expected = gdwg::graph<std::string, double>{};
+	{
+		auto g = durable(dir.path);
+		CHECK(g.get().empty());
+		CHECK(g.insert_node("b"));
+		CHECK(g.insert_node("a"));
+		CHECK(!g.insert_node("a"));
+		CHECK(g.insert_node("c"));
+		CHECK(g.insert_edge("a", "b", 1.5));
+		CHECK(g.insert_edge("b", "c", -2.0));
+		CHECK(g.insert_edge("c", "a", 0.25));
+		CHECK_THROWS(g.insert_edge("a", "z", 1.0));
+		CHECK(g.replace_node("a", "d")); // moves to the end of the node order
+		CHECK(g.erase_edge("b", "c", -2.0));
+		g.insert_node("e");
+		g.insert_edge("e", "b", 3.0);
+		g.merge_replace_node("e", "d");
+		CHECK(g.lsn() == 11);
+		g.commit();
+		expected = g.get();
+	}
+	CHECK(expected.nodes() == std::vector<std::string>{"b", "c", "d"});
+
+	SECTION("reopening replays the log") {
+		auto g = durable(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.lsn() == 11);
+	}
+	SECTION("compaction moves everything into the snapshot") {
+		{
+			auto g = durable(dir.path);
+			g.compact();
+			CHECK(std::filesystem::file_size(dir.path / "wal") == 0);
+			g.erase_node("c");
+			g.insert_edge("b", "b", 7.0);
+		}
+		expected.erase_node("c");
+		expected.insert_edge("b", "b", 7.0);
+		auto g = durable(dir.path);
+		CHECK(g.get() == expected);
+		CHECK(g.lsn() == 13);
+	}
+	SECTION("records already in the snapshot are skipped") {
+		// a crash after the new snapshot is in place but before the log was emptied
+		std::filesystem::copy_file(dir.path / "wal", dir.path / "wal.old");
+		{
+			auto g = durable(dir.path);
+			g.compact();
+		}
+		std::filesystem::rename(dir.path / "wal.old", dir.path / "wal");
+		auto g = durable(dir.path);
+		CHECK(g.get() == expected);
+		g.clear();
+		g.insert_node("z");
+		g.commit();
+		CHECK(durable(dir.path).get() == gdwg::graph<std::string, double>{"z"});
+	}
+	SECTION("a damaged snapshot is refused") {
+		{
+			auto g = durable(dir.path);
+			g.compact();
+		}
+		append_bytes(dir.path / "snapshot", "x");
+		CHECK_THROWS_AS(durable(dir.path), std::runtime_error);
+	}
+}
+
+TEST_CASE("durable_graph with many small modifications and group commit") {
+	auto const dir = scratch_directory("many");
+	auto expected = gdwg::graph<int, int>{};
+	{
+		auto g = gdwg::durable_graph<int, int>(dir.path, {.group_size = 64, .sync = false});
+		for (auto i = 0; i < 2000; ++i) {
+			g.insert_node(i % 300);
+			g.insert_node((i * 7) % 300);
+			g.insert_edge(i % 300, (i * 7) % 300, i % 5);
+			if (i % 3 == 0) {
+				g.erase_edge((i / 2) % 300, (i / 2 * 7) % 300, i % 5);
+			}
+			if (i == 1000) {
+				g.compact();
+			}
+		}
+		expected = g.get();
+	}
+	CHECK(gdwg::durable_graph<int, int>(dir.path).get() == expected);
+}
@@ -0,0 +1,155 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============
+// CHANGE STREAM
+// -------------
+
+namespace {
+	// what a downstream consumer does with the changes it pulls
+	template<typename N, typename E>
+	auto apply_changes(gdwg::graph<N, E>& replica,
+	                   std::vector<typename gdwg::graph<N, E>::change> const& changes) -> void {
+		for (auto const& c : changes) {
+			switch (c.kind) {
+			case gdwg::change_kind::node_added: replica.insert_node(c.from); break;
+			case gdwg::change_kind::node_renamed: replica.replace_node(c.from, c.to); break;
+			case gdwg::change_kind::node_merged: replica.merge_replace_node(c.from, c.to); break;
+			case gdwg::change_kind::node_erased: replica.erase_node(c.from); break;
+			case gdwg::change_kind::edge_added: replica.insert_edge(c.from, c.to, c.weight); break;
+			case gdwg::change_kind::edge_erased: replica.erase_edge(c.from, c.to, c.weight); break;
+			case gdwg::change_kind::cleared: replica.clear(); break;
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("change stream 1 (each modifier records what it changed)") {
+	using graph = gdwg::graph<std::string, int>;
+	using kind = gdwg::change_kind;
+	auto g = graph{"a", "b"};
+	CHECK(!g.has_change_stream());
+	CHECK(g.change_sequence() == 1);
+	g.enable_change_stream();
+	CHECK(g.has_change_stream());
+
+	g.insert_node("c");
+	CHECK(!g.insert_node("c")); // nothing changed, nothing recorded
+	g.insert_edge("a", "b", 1);
+	CHECK(!g.insert_edge("a", "b", 1));
+	g.insert_edge("b", "c", 2);
+	g.insert_edge("c", "c", 3);
+	g.replace_node("a", "z");
+	g.merge_replace_node("b", "c");
+	CHECK(!g.erase_edge("c", "z", 7));
+	g.erase_edge("c", "c", 2);
+	g.erase_node("z");
+	g.clear();
+
+	auto const expected = std::vector<graph::change>{{1, kind::node_added, "c", "", 0},
+	                                                 {2, kind::edge_added, "a", "b", 1},
+	                                                 {3, kind::edge_added, "b", "c", 2},
+	                                                 {4, kind::edge_added, "c", "c", 3},
+	                                                 {5, kind::node_renamed, "a", "z", 0},
+	                                                 {6, kind::node_merged, "b", "c", 0},
+	                                                 {7, kind::edge_erased, "c", "c", 2},
+	                                                 {8, kind::node_erased, "z", "", 0},
+	                                                 {9, kind::cleared, "", "", 0}};
+	auto const all = g.changes_since(1);
+	CHECK(all.changes == expected);
+	CHECK(all.next == 10);
+	CHECK(g.change_sequence() == 10);
+}
+
+TEST_CASE("change stream 2 (pulling in batches and retention)") {
+	using graph = gdwg::graph<int, int>;
+	auto g = graph{};
+	g.enable_change_stream(4);
+	for (auto i = 0; i < 6; ++i) {
+		g.insert_node(i);
+	}
+	SECTION("batches pick up where the last one stopped") {
+		auto batch = g.changes_since(3, 2);
+		CHECK(batch.changes.size() == 2);
+		CHECK(batch.changes.front().from == 2);
+		batch = g.changes_since(batch.next, 2);
+		CHECK(batch.changes.size() == 2);
+		CHECK(batch.changes.back().from == 5);
+		batch = g.changes_since(batch.next);
+		CHECK(batch.changes.empty());
+		CHECK(batch.next == 7);
+	}
+	SECTION("a consumer that fell too far behind is told so") {
+		CHECK_THROWS_WITH(g.changes_since(2),
+		                  "Cannot call gdwg::graph<N, E>::changes_since on changes that are no "
+		                  "longer retained");
+		CHECK(g.changes_since(3).changes.size() == 4);
+	}
+	SECTION("disabling drops the log but not the numbering") {
+		g.disable_change_stream();
+		g.insert_node(100);
+		CHECK(g.change_sequence() == 7);
+		g.enable_change_stream();
+		g.insert_node(101);
+		auto const added = graph::change{7, gdwg::change_kind::node_added, 101, 0, 0};
+		CHECK(g.changes_since(7).changes == std::vector<graph::change>{added});
+	}
+	SECTION("copies and moves take the log with them") {
+		auto copy = g;
+		copy.insert_node(50);
+		CHECK(copy.change_sequence() == 8);
+		CHECK(g.change_sequence() == 7);
+		auto const moved = std::move(copy);
+		CHECK(moved.changes_since(4).changes.back().from == 50);
+	}
+}
+
+TEST_CASE("change stream 3 (a replica kept in sync from the stream alone)") {
+	using graph = gdwg::graph<int, double>;
+	auto g = graph{};
+	g.enable_change_stream(1000);
+	auto replica = graph{};
+	auto next = g.change_sequence();
+	auto sync = [&] {
+		auto batch = g.changes_since(next);
+		apply_changes(replica, batch.changes);
+		next = batch.next;
+		return replica == g;
+	};
+
+	for (auto round = 0; round < 20; ++round) {
+		for (auto i = 0; i < 40; ++i) {
+			auto const a = (round * 31 + i * 7) % 50;
+			auto const b = (round * 17 + i * 13) % 50;
+			g.insert_node(a);
+			g.insert_node(b);
+			g.insert_edge(a, b, static_cast<double>(i % 4));
+		}
+		g.erase_node((round * 3) % 50);
+		if (g.is_node(round) and !g.is_node(round + 50)) {
+			g.replace_node(round, round + 50);
+		}
+		if (g.is_node(round + 1) and g.is_node(round + 2)) {
+			g.merge_replace_node(round + 1, round + 2);
+		}
+		auto first = g.begin();
+		auto after = g.erase_edge(first);
+		auto last = after;
+		for (auto i = 0; i < 5 and last != g.end(); ++i) {
+			++last;
+		}
+		g.erase_edge(after, last);
+		CHECK(sync());
+	}
+	auto first = g.begin();
+	auto end = g.end();
+	g.erase_edge(first, end); // the range erase up to end() now removes the edges
+	CHECK(g.begin() == g.end());
+	CHECK(sync());
+	g.clear();
+	CHECK(sync());
+}
@@ -0,0 +1,94 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ===============
+// DIFF AND PATCH
+// ---------------
+
+TEST_CASE("gdwg::diff") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const va = std::vector<graph::value_type>{{"a", "b", 1},
+	                                               {"a", "b", 2},
+	                                               {"b", "c", 3},
+	                                               {"c", "a", 4},
+	                                               {"d", "a", 5}};
+	auto const vb = std::vector<graph::value_type>{{"a", "b", 2},
+	                                               {"a", "e", 6},
+	                                               {"b", "c", 3},
+	                                               {"e", "e", 7}};
+	auto const a = graph(va.begin(), va.end());
+	auto b = graph(vb.begin(), vb.end());
+	b.insert_node("f");
+
+	SECTION("only the differences, and no edge that goes with an erased node") {
+		auto const p = gdwg::diff(a, b);
+		CHECK(p.erased_nodes == std::vector<std::string>{"d"});
+		CHECK(p.erased_edges == std::vector<graph::value_type>{{"a", "b", 1}, {"c", "a", 4}});
+		CHECK(p.added_nodes == std::vector<std::string>{"e", "f"});
+		CHECK(p.added_edges == std::vector<graph::value_type>{{"a", "e", 6}, {"e", "e", 7}});
+		CHECK(gdwg::diff(b, b).empty());
+		CHECK(gdwg::diff(graph{}, graph{}).empty());
+	}
+	SECTION("applying the diff gives the target, both ways") {
+		auto g = a;
+		gdwg::apply(g, gdwg::diff(a, b));
+		CHECK(g == b);
+		gdwg::apply(g, gdwg::diff(b, a));
+		CHECK(g == a);
+		auto const empty = graph{};
+		gdwg::apply(g, gdwg::diff(a, empty));
+		CHECK(g.empty());
+		gdwg::apply(g, gdwg::diff(empty, b));
+		CHECK(g == b);
+	}
+	SECTION("the slow path keeps the change stream and topological order up to date") {
+		auto g = a;
+		g.enable_change_stream();
+		gdwg::apply(g, gdwg::diff(a, b));
+		CHECK(g == b);
+		CHECK(g.changes_since(1).changes.size() == 7);
+
+		auto dag = graph{"x", "y"};
+		dag.enable_topological_order();
+		auto target = graph{"x", "y"};
+		target.insert_edge("x", "y", 0);
+		target.insert_edge("y", "x", 0);
+		CHECK_THROWS(gdwg::apply(dag, gdwg::diff(dag, target)));
+	}
+	SECTION("a patch that doesn't fit throws") {
+		auto const p = gdwg::diff(a, b);
+		auto g = b;
+		CHECK_THROWS_WITH(gdwg::apply(g, p),
+		                  "Cannot call gdwg::graph<N, E>::apply with a patch that doesn't match "
+		                  "the graph");
+		auto h = graph{"a", "b"};
+		auto const add_edge = graph::patch{{}, {}, {}, {{"a", "z", 1}}};
+		CHECK_THROWS(gdwg::apply(h, add_edge));
+	}
+}
+
+TEST_CASE("gdwg::diff on larger graphs") {
+	using graph = gdwg::graph<int, int>;
+	auto v1 = std::vector<graph::value_type>{};
+	auto v2 = std::vector<graph::value_type>{};
+	for (auto i = 0; i < 5000; ++i) {
+		auto const e = graph::value_type{(i * 7919) % 700, (i * 10007) % 701, i % 4};
+		if (i % 5 != 0) {
+			v1.push_back(e);
+		}
+		if (i % 7 != 0) {
+			v2.push_back(e);
+		}
+	}
+	auto g1 = graph(v1.begin(), v1.end());
+	auto const g2 = graph(v2.begin(), v2.end());
+	auto const p = gdwg::diff(g1, g2);
+	CHECK(!p.empty());
+	gdwg::apply(g1, p);
+	CHECK(g1 == g2);
+	CHECK(gdwg::diff(g1, g2).empty());
+}
@@ -0,0 +1,138 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/views.hpp"
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// ============================
+// INDUCED VIEWS AND EGO VIEWS
+// ----------------------------
+
+namespace {
+	template<typename View>
+	auto edges_of(View const& view) {
+		using graph = std::remove_cvref_t<decltype(view.parent())>;
+		auto edges = std::vector<typename graph::value_type>{};
+		for (auto const& [from, to, weight] : view) {
+			edges.push_back({from, to, weight});
+		}
+		return edges;
+	}
+} // namespace
+
+TEST_CASE("induced_view") {
+	using graph = gdwg::graph<std::string, int>;
+	using edge = graph::value_type;
+	auto g = graph{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("a", "d", 3);
+	g.insert_edge("b", "a", 4);
+	g.insert_edge("b", "b", 5);
+	g.insert_edge("c", "d", 6);
+	g.insert_edge("d", "a", 7);
+	g.insert_edge("d", "a", 8);
+	auto const view = gdwg::induced_view(g, {"d", "a", "b", "a", "zzz"});
+
+	SECTION("nodes are sorted, without duplicates or values that aren't in the graph") {
+		CHECK(view.nodes() == std::vector<std::string>{"a", "b", "d"});
+		CHECK(view.is_node("b"));
+		CHECK(!view.is_node("c"));
+		CHECK(!view.empty());
+		CHECK(gdwg::induced_view(g, {"x"}).empty());
+	}
+	SECTION("only edges with both ends in the view are seen") {
+		auto const expected = std::vector<edge>{{"a", "b", 1},
+		                                        {"a", "d", 3},
+		                                        {"b", "a", 4},
+		                                        {"b", "b", 5},
+		                                        {"d", "a", 7},
+		                                        {"d", "a", 8}};
+		CHECK(edges_of(view) == expected);
+		CHECK(view.connections("a") == std::vector<std::string>{"b", "d"});
+		CHECK(view.weights("d", "a") == std::vector<int>{7, 8});
+		CHECK(view.weights("a", "a").empty());
+		CHECK(view.is_connected("b", "b"));
+		CHECK(!view.is_connected("d", "b"));
+	}
+	SECTION("nodes outside the view can't be asked about") {
+		CHECK_THROWS_WITH(view.connections("c"),
+		                  "Cannot call gdwg::induced_view<N, E>::connections if src doesn't exist in "
+		                  "the view");
+		CHECK_THROWS_WITH(view.weights("a", "c"),
+		                  "Cannot call gdwg::induced_view<N, E>::weights if src or dst node don't "
+		                  "exist in the view");
+		CHECK_THROWS_AS(view.is_connected("c", "a"), std::runtime_error);
+	}
+	SECTION("changes to the parent's edges show through") {
+		g.insert_edge("b", "d", 9);
+		g.erase_edge("a", "b", 1);
+		g.erase_node("d");
+		CHECK(edges_of(view) == std::vector<edge>{{"b", "a", 4}, {"b", "b", 5}});
+		CHECK(view.connections("d").empty());
+		CHECK(view.weights("b", "d").empty());
+	}
+	SECTION("materialize copies the view into a graph of its own") {
+		auto copy = view.materialize();
+		auto expected = graph{"a", "b", "d"};
+		for (auto const& e : edges_of(view)) {
+			expected.insert_edge(e.from, e.to, e.weight);
+		}
+		CHECK(copy == expected);
+		g.clear();
+		CHECK(copy == expected);
+	}
+	SECTION("a view with no edges") {
+		auto const lonely = gdwg::induced_view(g, {"c", "e"});
+		CHECK(lonely.begin() == lonely.end());
+		CHECK(lonely.materialize() == graph{"c", "e"});
+	}
+}
+
+TEST_CASE("ego_view") {
+	using graph = gdwg::graph<int, int>;
+	// a chain 0 -> 1 -> ... -> 9 with a shortcut 0 -> 5, and 9 -> 0 to close it
+	auto g = graph{};
+	for (auto i = 0; i < 10; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 9; ++i) {
+		g.insert_edge(i, i + 1, i);
+	}
+	g.insert_edge(0, 5, 50);
+	g.insert_edge(9, 0, 90);
+
+	CHECK(gdwg::ego_view(g, 0, 0).nodes() == std::vector<int>{0});
+	CHECK(gdwg::ego_view(g, 0, 1).nodes() == std::vector<int>{0, 1, 5});
+	auto const two = gdwg::ego_view(g, 0, 2);
+	CHECK(two.nodes() == std::vector<int>{0, 1, 2, 5, 6});
+	CHECK(two.connections(0) == std::vector<int>{1, 5});
+	CHECK(two.connections(5) == std::vector<int>{6});
+	CHECK(two.connections(6).empty());
+	CHECK(gdwg::ego_view(g, 7, 3).nodes() == std::vector<int>{0, 7, 8, 9});
+	CHECK(gdwg::ego_view(g, 3, 100).materialize() == g);
+	CHECK_THROWS_WITH(gdwg::ego_view(g, 42, 1),
+	                  "Cannot call gdwg::ego_view if n doesn't exist in the graph");
+}
+
+TEST_CASE("graph::edges_from") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(2, 1, 4);
+	g.insert_edge(2, 3, 5);
+	g.insert_edge(1, 2, 6);
+	auto [first, last] = g.edges_from(2);
+	REQUIRE(first != last);
+	CHECK(std::get<2>(*first) == 4);
+	++first;
+	CHECK(std::get<2>(*first) == 5);
+	++first;
+	CHECK(first == last);
+	auto const [none, none_end] = g.edges_from(3);
+	CHECK(none == none_end);
+	CHECK_THROWS_WITH(g.edges_from(4),
+	                  "Cannot call gdwg::graph<N, E>::edges_from if src doesn't exist in the graph");
+}
@@ -0,0 +1,186 @@
+#include "gdwg/algorithms/partition.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ============
+// PARTITIONING
+// ------------
+
+namespace {
+	// `clusters` groups of `size` nodes, each node linked to the next four of its own group, plus
+	// one edge from each group to the next. Node x is numbered x * stride mod the node count, so
+	// a stride other than 1 scatters the groups over the node order.
+	auto clustered_graph(int clusters, int size, int stride = 1) -> gdwg::graph<int, int> {
+		auto const total = clusters * size;
+		auto const id = [&](int x) { return x * stride % total; };
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < total; ++i) {
+			g.insert_node(i);
+		}
+		for (auto c = 0; c < clusters; ++c) {
+			for (auto i = 0; i < size; ++i) {
+				for (auto step = 1; step <= 4; ++step) {
+					g.insert_edge(id(c * size + i), id(c * size + (i + step) % size), step);
+				}
+			}
+			g.insert_edge(id(c * size), id(((c + 1) % clusters) * size + size / 2), 0);
+		}
+		return g;
+	}
+
+	auto part_sizes(gdwg::algorithms::partitioning const& p) -> std::vector<std::size_t> {
+		auto sizes = std::vector<std::size_t>(p.parts, 0);
+		for (auto const i : p.part) {
+			++sizes[i];
+		}
+		return sizes;
+	}
+} // namespace
+
+TEST_CASE("partition finds the clusters") {
+	using namespace gdwg::algorithms;
+	auto const g = clustered_graph(4, 50);
+	for (auto const method : {partition_method::fennel, partition_method::ldg}) {
+		auto const p = partition(g, 4, {.method = method});
+		CHECK(p.parts == 4);
+		REQUIRE(p.part.size() == 200);
+		for (auto const size : part_sizes(p)) {
+			CHECK(size <= 55); // 1.1 * 200 / 4
+		}
+		CHECK(p.edge_cut <= 20);
+
+		// a node-number split cuts 4 of the 804 edges here, so compare against one that doesn't
+		// follow the structure
+		auto round_robin = partitioning{4, std::vector<std::uint32_t>(200), 0};
+		for (auto i = 0U; i < 200; ++i) {
+			round_robin.part[i] = i % 4;
+		}
+		auto cut = std::size_t{0};
+		for (auto const& [from, to, weight] : g) {
+			cut += round_robin.part[static_cast<std::size_t>(from)]
+			             != round_robin.part[static_cast<std::size_t>(to)]
+			          ? 1
+			          : 0;
+		}
+		CHECK(p.edge_cut < cut / 10);
+	}
+	// streamed in node order alone, the groups would be cut into pieces
+	auto const p = partition(clustered_graph(4, 50, 7919), 4);
+	CHECK(p.edge_cut <= 20);
+	auto const streamed = partition(clustered_graph(4, 50, 7919), 4, {.coarsen = false});
+	CHECK(streamed.edge_cut > p.edge_cut);
+}
+
+TEST_CASE("partition keeps parts balanced") {
+	using namespace gdwg::algorithms;
+	// a star pulls everything towards one part; the capacity must stop it
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 100; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < 100; ++i) {
+		g.insert_edge(0, i, 1);
+		g.insert_edge(i, 0, 1);
+	}
+	auto const p = partition(g, 3, {.imbalance = 1.0});
+	auto sizes = part_sizes(p);
+	std::sort(sizes.begin(), sizes.end());
+	CHECK(sizes == std::vector<std::size_t>{33, 33, 34});
+	CHECK(partition(gdwg::graph<int, int>{}, 3).part.empty());
+	CHECK(partition(g, 1).edge_cut == 0);
+	CHECK_THROWS_AS(partition(g, 0), std::invalid_argument);
+	CHECK_THROWS_AS(partition(g, 2, {.imbalance = 0.5}), std::invalid_argument);
+}
+
+TEST_CASE("split hands each process its part") {
+	using namespace gdwg::algorithms;
+	constexpr auto k = std::size_t{3};
+	auto const g = clustered_graph(6, 20);
+	auto const p = partition(g, k);
+	auto const parts = split(g, p);
+	REQUIRE(parts.size() == k);
+
+	// each "process" works on its part alone: it counts its edges, and the edges it would have
+	// to send along to each other process
+	struct report {
+		std::size_t edges = 0;
+		std::map<std::size_t, std::size_t> sent{};
+		std::vector<int> boundary{};
+	};
+	auto reports = std::vector<report>(k);
+	auto processes = std::vector<std::thread>{};
+	for (auto i = std::size_t{0}; i < k; ++i) {
+		processes.emplace_back([&, i] {
+			auto const& part = parts[i];
+			auto& r = reports[i];
+			auto const owner = std::map<int, std::size_t>(part.ghosts.begin(), part.ghosts.end());
+			for (auto const& [from, to, weight] : part.g) {
+				++r.edges;
+				if (!std::binary_search(part.owned.begin(), part.owned.end(), to)) {
+					++r.sent[owner.at(to)];
+					r.boundary.push_back(from);
+				}
+			}
+		});
+	}
+	for (auto& process : processes) {
+		process.join();
+	}
+
+	auto all = gdwg::graph<int, int>{};
+	auto owned = std::size_t{0};
+	auto edges = std::size_t{0};
+	auto sent = std::size_t{0};
+	for (auto i = std::size_t{0}; i < k; ++i) {
+		auto const& part = parts[i];
+		owned += part.owned.size();
+		edges += reports[i].edges;
+		for (auto const& [to, count] : reports[i].sent) {
+			CHECK(to != i);
+			sent += count;
+		}
+		for (auto const n : part.owned) {
+			CHECK(p.part[static_cast<std::size_t>(n)] == i);
+			all.insert_node(n);
+		}
+		for (auto const& [ghost, where] : part.ghosts) {
+			CHECK(p.part[static_cast<std::size_t>(ghost)] == where);
+		}
+		for (auto const n : reports[i].boundary) {
+			CHECK(std::binary_search(part.boundary.begin(), part.boundary.end(), n));
+		}
+	}
+	for (auto const& part : parts) {
+		for (auto const& [from, to, weight] : part.g) {
+			all.insert_edge(from, to, weight);
+		}
+	}
+	auto boundary = std::vector<int>{};
+	for (auto const& [from, to, weight] : g) {
+		if (p.part[static_cast<std::size_t>(from)] != p.part[static_cast<std::size_t>(to)]) {
+			boundary.push_back(from);
+			boundary.push_back(to);
+		}
+	}
+	std::sort(boundary.begin(), boundary.end());
+	boundary.erase(std::unique(boundary.begin(), boundary.end()), boundary.end());
+	auto listed = std::vector<int>{};
+	for (auto const& part : parts) {
+		listed.insert(listed.end(), part.boundary.begin(), part.boundary.end());
+	}
+	std::sort(listed.begin(), listed.end());
+	CHECK(listed == boundary);
+	CHECK(owned == 120);
+	CHECK(all == g);
+	CHECK(edges == 120 * 4 + 6);
+	CHECK(sent == p.edge_cut);
+}
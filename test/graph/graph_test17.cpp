@@ -0,0 +1,151 @@
+#include "gdwg/algorithms/components.hpp"
+#include "gdwg/algorithms/pagerank.hpp"
+#include "gdwg/algorithms/reorder.hpp"
+#include "gdwg/frozen_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// =======================
+// REORDERING FOR LOCALITY
+// -----------------------
+
+namespace {
+	// every edge as (from value, to value, weight), sorted, whatever the numbering
+	template<typename N, typename E>
+	auto edge_values(gdwg::frozen_graph<N, E> const& g) -> std::vector<std::tuple<N, N, E>> {
+		auto edges = std::vector<std::tuple<N, N, E>>{};
+		for (auto from = gdwg::node_id{0}; from < g.size(); ++from) {
+			auto const targets = g.out_edges(from);
+			auto const weights = g.out_weights(from);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				edges.emplace_back(g.node(from), g.node(targets[i]), weights[i]);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		return edges;
+	}
+
+	// the largest difference between the ids at the two ends of an edge
+	template<typename N, typename E>
+	auto bandwidth(gdwg::frozen_graph<N, E> const& g) -> std::size_t {
+		auto widest = std::size_t{0};
+		for (auto from = gdwg::node_id{0}; from < g.size(); ++from) {
+			for (auto const to : g.out_edges(from)) {
+				widest = std::max<std::size_t>(widest, from < to ? to - from : from - to);
+			}
+		}
+		return widest;
+	}
+
+	// a side x side grid with edges right and down, its nodes numbered in a scattered order
+	auto scattered_grid(int side) -> gdwg::graph<int, int> {
+		auto const total = side * side;
+		auto const id = [&](int x, int y) { return (y * side + x) * 7919 % total; };
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < total; ++i) {
+			g.insert_node(i);
+		}
+		for (auto y = 0; y < side; ++y) {
+			for (auto x = 0; x < side; ++x) {
+				if (x + 1 < side) {
+					g.insert_edge(id(x, y), id(x + 1, y), x);
+				}
+				if (y + 1 < side) {
+					g.insert_edge(id(x, y), id(x, y + 1), y);
+				}
+			}
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("frozen_graph::permute") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "d", 2);
+	g.insert_edge("a", "d", 1);
+	g.insert_edge("c", "a", 3);
+	g.insert_edge("d", "d", 4);
+	auto const frozen = g.freeze();
+	auto const order = std::vector<gdwg::node_id>{3, 1, 0, 2}; // d b a c
+	auto const permuted = frozen.permute(order);
+
+	CHECK(permuted.nodes() == std::vector<std::string>{"d", "b", "a", "c"});
+	CHECK(permuted.id("a") == 2);
+	CHECK(permuted.id("d") == 0);
+	CHECK(permuted.node(permuted.id("c")) == "c");
+	CHECK_THROWS_AS(permuted.id("z"), std::runtime_error);
+	CHECK(edge_values(permuted) == edge_values(frozen));
+	// a's edges are sorted by their new dst ids (d is now 0), then weight
+	auto const a = permuted.id("a");
+	CHECK(std::vector<gdwg::node_id>(permuted.out_edges(a).begin(), permuted.out_edges(a).end())
+	      == std::vector<gdwg::node_id>{0, 0, 1});
+	CHECK(std::vector<int>(permuted.out_weights(a).begin(), permuted.out_weights(a).end())
+	      == std::vector<int>{1, 2, 1});
+	CHECK(edge_values(permuted.transpose()) == edge_values(frozen.transpose()));
+	CHECK(permuted.transpose().id("b") == 1);
+
+	auto const identity = std::vector<gdwg::node_id>{0, 1, 2, 3};
+	CHECK(frozen.permute(identity) == frozen);
+	CHECK_THROWS_AS(frozen.permute(std::vector<gdwg::node_id>{0, 1, 2}), std::invalid_argument);
+	CHECK_THROWS_AS(frozen.permute(std::vector<gdwg::node_id>{0, 1, 1, 3}), std::invalid_argument);
+	CHECK_THROWS_AS(frozen.permute(std::vector<gdwg::node_id>{0, 1, 2, 4}), std::invalid_argument);
+}
+
+TEST_CASE("reorder") {
+	using namespace gdwg::algorithms;
+	auto const g = scattered_grid(20);
+	auto const frozen = g.freeze();
+	CHECK(bandwidth(frozen) > 300);
+
+	for (auto const strategy : {node_ordering::reverse_cuthill_mckee,
+	                            node_ordering::degree_descending,
+	                            node_ordering::breadth_first})
+	{
+		auto const reordered = reorder(g, strategy);
+		CHECK(edge_values(reordered) == edge_values(frozen));
+		for (auto const n : g.nodes()) {
+			CHECK(reordered.node(reordered.id(n)) == n);
+		}
+	}
+
+	SECTION("reverse Cuthill-McKee narrows the band to about a row of the grid") {
+		CHECK(bandwidth(reorder(frozen, node_ordering::reverse_cuthill_mckee)) <= 25);
+	}
+	SECTION("breadth first also keeps the ids of neighbours close") {
+		auto const reordered = reorder(frozen, node_ordering::breadth_first);
+		CHECK(bandwidth(reordered) <= 40);
+		CHECK(reordered.node(0) == frozen.node(0));
+	}
+	SECTION("degree order puts the hubs first") {
+		auto star = gdwg::graph<int, int>{1, 2, 3, 4, 5};
+		for (auto i = 1; i <= 4; ++i) {
+			star.insert_edge(i, 5, 0);
+		}
+		star.insert_edge(2, 3, 0);
+		auto const order = ordering(star.freeze(), node_ordering::degree_descending);
+		CHECK(order == std::vector<gdwg::node_id>{4, 1, 2, 0, 3});
+	}
+	SECTION("algorithms give the same answers on a reordered graph") {
+		auto const reordered = reorder(frozen, node_ordering::reverse_cuthill_mckee);
+		auto const before = pagerank(frozen);
+		auto const after = pagerank(reordered);
+		CHECK(after.iterations == before.iterations);
+		for (auto i = gdwg::node_id{0}; i < frozen.size(); ++i) {
+			CHECK(std::abs(after.rank[reordered.id(frozen.node(i))] - before.rank[i]) < 1e-12);
+		}
+		CHECK(wcc(reordered).count == 1);
+		CHECK(scc(reordered).count == frozen.size());
+	}
+	SECTION("an empty graph") {
+		CHECK(reorder(gdwg::graph<int, int>{}, node_ordering::reverse_cuthill_mckee).empty());
+	}
+}
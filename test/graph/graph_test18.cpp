@@ -0,0 +1,151 @@
+// this test is about the instrumentation, so it compiles it in whatever the build options say
+#ifndef GDWG_GRAPH_STATS
+#define GDWG_GRAPH_STATS
+#endif
+
+#include "gdwg/graph.hpp"
+#include "gdwg/stats.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ===============
+// INSTRUMENTATION
+// ---------------
+
+// compiled out, the counters take no space and the hooks have nothing to do
+static_assert(std::is_empty_v<gdwg::detail::graph_counters<false>>);
+static_assert(gdwg::stats_enabled);
+
+TEST_CASE("stats counts the work each call does") {
+	using graph = gdwg::graph<std::string, int>;
+	auto g = graph{};
+	CHECK(g.stats().tree_searches == 0);
+
+	g.insert_node("a");
+	g.insert_node("b");
+	CHECK(!g.insert_node("a"));
+	auto const nodes = g.stats();
+	CHECK(nodes.make_shared_calls == 2);
+	CHECK(nodes.node_value_copies == 2);
+	// two make_shared calls, plus the tree's root leaf: allocated for the first node, then
+	// reallocated larger for the second
+	CHECK(nodes.allocations == 2 + 2);
+	// each insert searches (is_node), and each new node is then emplaced
+	CHECK(nodes.tree_searches == 3 + 2);
+	CHECK(nodes.node_comparisons > 0);
+	CHECK(nodes.edge_comparisons == 0);
+
+	g.insert_edge("a", "b", 1);
+	auto const edge = g.stats();
+	CHECK(edge.make_shared_calls == 3);
+	CHECK(edge.weight_copies == 1);
+	CHECK(edge.edge_comparisons == 0); // the first edge has nothing to be compared with
+	g.insert_edge("b", "a", 1);
+	CHECK(g.stats().edge_comparisons > 0);
+
+	auto const before = g.stats();
+	CHECK(g.weights("a", "b") == std::vector<int>{1});
+	CHECK(g.nodes().size() == 2);
+	auto const after = g.stats();
+	CHECK(after.weight_copies == before.weight_copies + 1);
+	CHECK(after.node_value_copies == before.node_value_copies + 2);
+	CHECK(after.make_shared_calls == before.make_shared_calls);
+}
+
+TEST_CASE("stats times each public method") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 100; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 50; ++i) {
+		g.insert_edge(i, i + 1, i);
+	}
+	CHECK(g.is_connected(3, 4));
+	auto const s = g.stats();
+	CHECK(s[gdwg::graph_method::insert_node].calls == 100);
+	CHECK(s[gdwg::graph_method::insert_edge].calls == 50);
+	// the is_node calls made by insert_node and insert_edge are part of those calls
+	CHECK(s[gdwg::graph_method::is_node].calls == 0);
+	CHECK(s[gdwg::graph_method::is_connected].calls == 1);
+	CHECK(s[gdwg::graph_method::erase_node].calls == 0);
+
+	auto const& inserts = s[gdwg::graph_method::insert_node];
+	auto bucketed = std::uint64_t{0};
+	for (auto const c : inserts.count) {
+		bucketed += c;
+	}
+	CHECK(bucketed == 100);
+	CHECK(inserts.total.count() > 0);
+	CHECK(inserts.quantile(0.5) <= inserts.quantile(1.0));
+	CHECK(inserts.quantile(1.0) > std::chrono::nanoseconds{0});
+	CHECK(gdwg::method_name(gdwg::graph_method::merge_replace_node) == "merge_replace_node");
+}
+
+TEST_CASE("trace sink") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	auto events = std::vector<gdwg::graph_method>{};
+	g.set_trace_sink([&](gdwg::trace_event const& e) {
+		CHECK(e.duration >= std::chrono::nanoseconds{0});
+		events.push_back(e.method);
+	});
+	g.insert_edge(1, 2, 5);
+	g.erase_node(3);
+	CHECK(g.connections(1) == std::vector<int>{2});
+	CHECK(events
+	      == std::vector<gdwg::graph_method>{gdwg::graph_method::insert_edge,
+	                                         gdwg::graph_method::erase_node,
+	                                         gdwg::graph_method::connections});
+
+	SECTION("copies start afresh, without the sink") {
+		auto copy = g;
+		CHECK(copy.stats().make_shared_calls == 0);
+		copy.insert_node(9);
+		CHECK(events.size() == 3);
+		CHECK(copy.stats()[gdwg::graph_method::insert_node].calls == 1);
+	}
+	SECTION("an empty sink removes it") {
+		g.set_trace_sink({});
+		g.clear();
+		CHECK(events.size() == 3);
+		CHECK(g.stats()[gdwg::graph_method::clear].calls == 1);
+	}
+}
+
+TEST_CASE("stats from several threads reading at once") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 64; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 64; ++i) {
+		g.insert_edge(i, (i * 7) % 64, i);
+	}
+	auto const before = g.stats();
+	auto mutex = std::mutex{};
+	auto traced = 0;
+	g.set_trace_sink([&](gdwg::trace_event const&) {
+		auto const lock = std::scoped_lock(mutex);
+		++traced;
+	});
+	auto readers = std::vector<std::thread>{};
+	for (auto t = 0; t < 4; ++t) {
+		readers.emplace_back([&g] {
+			for (auto i = 0; i < 1000; ++i) {
+				static_cast<void>(g.is_connected(i % 64, (i * 7) % 64));
+			}
+		});
+	}
+	for (auto& r : readers) {
+		r.join();
+	}
+	auto const after = g.stats();
+	CHECK(after[gdwg::graph_method::is_connected].calls == 4000);
+	CHECK(traced == 4000);
+	// is_connected does two is_node searches and one edge search
+	CHECK(after.tree_searches - before.tree_searches == 4000 * 3);
+}
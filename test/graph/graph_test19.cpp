@@ -0,0 +1,103 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/memory.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// =================
+// MEMORY ACCOUNTING
+// -----------------
+
+namespace {
+	// a weight that keeps its history on the heap
+	struct history {
+		std::vector<int> values{};
+		[[nodiscard]] auto operator==(history const&) const -> bool = default;
+		[[nodiscard]] auto operator<=>(history const&) const = default;
+	};
+
+	auto ring(int size) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < size; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < size; ++i) {
+			g.insert_edge(i, (i + 1) % size, i);
+		}
+		return g;
+	}
+} // namespace
+
+template<>
+struct gdwg::heap_bytes<history> {
+	[[nodiscard]] static auto of(history const& h) noexcept -> std::size_t {
+		return heap_bytes<std::vector<int>>::of(h.values);
+	}
+};
+
+TEST_CASE("memory_usage grows with the graph") {
+	CHECK(gdwg::graph<int, int>{}.memory_usage().total() == 0);
+
+	auto const small = ring(10).memory_usage();
+	auto const large = ring(1000).memory_usage();
+	CHECK(small.nodes > 0);
+	CHECK(small.edges > 0);
+	CHECK(small.index > 0);
+	CHECK(small.payload == 0);
+	CHECK(small.change_log == 0);
+	CHECK(large.nodes == 100 * small.nodes);
+	CHECK(large.edges == 100 * small.edges);
+	CHECK(large.index == 100 * small.index);
+	CHECK(large.total() == large.nodes + large.edges + large.index);
+	// each edge costs at least its two node pointers and its weight
+	CHECK(small.edges >= 10 * (2 * sizeof(void*) + sizeof(int)));
+
+	auto g = ring(10);
+	g.erase_node(0);
+	CHECK(g.memory_usage().nodes == 9 * small.nodes / 10);
+	CHECK(g.memory_usage().edges == 8 * small.edges / 10);
+}
+
+TEST_CASE("memory_usage counts what values own on the heap") {
+	auto g = gdwg::graph<std::string, history>{"a", std::string(100, 'b')};
+	auto const strings = g.memory_usage().payload;
+	CHECK(strings >= 101);
+	CHECK(strings < 101 + 64);
+
+	g.insert_edge("a", "a", history{std::vector<int>(25)});
+	CHECK(g.memory_usage().payload == strings + 25 * sizeof(int));
+	CHECK(gdwg::heap_bytes<std::string>::of("short") == 0);
+	CHECK(gdwg::heap_bytes<std::vector<std::string>>::of({"x", std::string(50, 'y')})
+	      >= 2 * sizeof(std::string) + 51);
+
+	g.enable_change_stream();
+	g.insert_node(std::string(200, 'c'));
+	CHECK(g.memory_usage().change_log >= sizeof(gdwg::graph<std::string, history>::change) + 201);
+}
+
+TEST_CASE("shrink_to_fit") {
+	auto g = ring(100);
+	g.erase_edge(99, 0, 99);
+	g.enable_topological_order();
+	g.enable_change_stream();
+	for (auto i = 0; i < 40; ++i) {
+		g.erase_node(i);
+	}
+	auto const before = g.memory_usage();
+	auto const order = g.topo_order();
+	g.shrink_to_fit();
+	auto const after = g.memory_usage();
+	CHECK(after.index < before.index);
+	CHECK(after.index == before.index - 40 * sizeof(void*));
+	CHECK(after.nodes == before.nodes);
+	CHECK(g.topo_order() == order);
+	g.insert_edge(40, 99, 0);
+	CHECK_THROWS_AS(g.insert_edge(99, 40, 0), std::runtime_error);
+	CHECK(g.changes_since(1).changes.size() == 40 + 1);
+
+	auto empty = gdwg::graph<int, int>{};
+	empty.shrink_to_fit();
+	CHECK(empty.memory_usage().total() == 0);
+}
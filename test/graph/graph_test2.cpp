@@ -77,6 +77,10 @@ TEST_CASE("Modifier 3 (replacing a node)") {
 		CHECK_NOTHROW(g1.replace_node(12.12, 42.42)); // new node doesnt exist
 		REQUIRE(g1.is_node(42.42));
 		CHECK(!g1.insert_edge(42.42, 99.9, "4"));
+		// the node moved past 7.7, so the node and edge orders have to be kept up to date
+		CHECK(g1.nodes() == std::vector<double>{1.1, 2.2, 7.7, 42.42, 99.9});
+		CHECK(g1.connections(42.42) == std::vector<double>{99.9});
+		CHECK(g1.find(42.42, 99.9, "4") != g1.end());
 	}
 	SECTION("insert edges in one node graph") {
 		using graph = gdwg::graph<int, double>;
@@ -0,0 +1,114 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <compare>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ===================
+// INLINE EDGE STORAGE
+// -------------------
+
+namespace {
+	// an int that isn't trivially copyable, so a graph of them keeps shared edges
+	struct boxed {
+		boxed() = default;
+		boxed(int v) // NOLINT(google-explicit-constructor)
+		: value{v} {}
+		boxed(boxed const& other)
+		: value{other.value} {}
+		auto operator=(boxed const& other) -> boxed& {
+			value = other.value;
+			return *this;
+		}
+		~boxed() {} // NOLINT(modernize-use-equals-default)
+		[[nodiscard]] auto operator==(boxed const&) const -> bool = default;
+		[[nodiscard]] auto operator<=>(boxed const&) const = default;
+		int value = 0;
+	};
+
+	auto plain(int i) -> int {
+		return i;
+	}
+	auto plain(boxed const& b) -> int {
+		return b.value;
+	}
+
+	// every edge as plain ints, in iteration order
+	template<typename N, typename E>
+	auto edges(gdwg::graph<N, E> const& g) -> std::vector<std::tuple<int, int, int>> {
+		auto result = std::vector<std::tuple<int, int, int>>{};
+		for (auto const& [from, to, weight] : g) {
+			result.emplace_back(plain(from), plain(to), plain(weight));
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto run(gdwg::graph<N, E>& g) -> void {
+		for (auto i = 0; i < 20; ++i) {
+			g.insert_node(N{i});
+		}
+		for (auto i = 0; i < 20; ++i) {
+			g.insert_edge(N{i}, N{(i * 3) % 20}, E{i % 4});
+			g.insert_edge(N{i}, N{(i + 1) % 20}, E{1});
+			g.insert_edge(N{(i + 1) % 20}, N{i}, E{2});
+		}
+		g.erase_edge(N{3}, N{4}, E{1});
+		g.erase_node(N{7});
+		g.replace_node(N{5}, N{25});
+		g.replace_node(N{0}, N{30});
+		g.merge_replace_node(N{8}, N{9});
+		g.merge_replace_node(N{12}, N{30});
+		auto it = g.find(N{10}, N{11}, E{1});
+		g.erase_edge(it);
+	}
+} // namespace
+
+static_assert(gdwg::graph<int, int>::stores_edges_inline);
+static_assert(gdwg::graph<char, double>::stores_edges_inline);
+static_assert(!gdwg::graph<std::string, int>::stores_edges_inline);
+static_assert(!gdwg::graph<int, std::string>::stores_edges_inline);
+static_assert(!gdwg::graph<boxed, int>::stores_edges_inline);
+
+TEST_CASE("inline and shared edges behave the same") {
+	auto flat = gdwg::graph<int, int>{};
+	auto shared = gdwg::graph<boxed, boxed>{};
+	run(flat);
+	run(shared);
+	CHECK(edges(flat) == edges(shared));
+	CHECK(flat.nodes().size() == shared.nodes().size());
+	CHECK(flat.weights(30, 1) == std::vector<int>{1});
+	CHECK(flat.connections(25) == std::vector<int>{4, 6, 15});
+	CHECK(flat.is_connected(25, 4));
+	CHECK(!flat.is_node(8));
+
+	auto const frozen = flat.freeze();
+	CHECK(frozen.edge_count() == edges(flat).size());
+	auto copy = flat;
+	CHECK(copy == flat);
+	copy.replace_node(25, 26);
+	CHECK(copy.connections(26) == std::vector<int>{4, 6, 15});
+	CHECK(flat.connections(25) == std::vector<int>{4, 6, 15});
+	// 25 has three edges out and three in, each of which comes back with 26
+	CHECK(flat.diff(copy).added_edges.size() == 6);
+	flat.apply(flat.diff(copy));
+	CHECK(flat == copy);
+}
+
+TEST_CASE("inline edges keep the topological order") {
+	auto g = gdwg::graph<char, double>{'a', 'b', 'c', 'd'};
+	g.enable_topological_order();
+	g.insert_edge('a', 'b', 0.5);
+	g.insert_edge('b', 'c', 1.5);
+	CHECK_THROWS_AS(g.insert_edge('c', 'a', 0.0), std::runtime_error);
+	g.replace_node('b', 'e');
+	CHECK(g.is_connected('e', 'c'));
+	CHECK_THROWS_AS(g.insert_edge('c', 'e', 0.0), std::runtime_error);
+	g.merge_replace_node('e', 'd');
+	CHECK(g.weights('a', 'd') == std::vector<double>{0.5});
+	g.erase_node('d');
+	CHECK(g.topo_order() == std::vector<char>{'a', 'c'});
+	CHECK(g.begin() == g.end());
+}
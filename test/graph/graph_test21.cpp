@@ -0,0 +1,115 @@
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ========================
+// STRING KEY PREFIXES
+// ------------------------
+
+namespace {
+	// strings that tie on their first eight bytes, differ only past them, are prefixes of one
+	// another, hold '\0' or bytes above 127, or are empty
+	auto awkward_strings() -> std::vector<std::string> {
+		using namespace std::string_literals;
+		return {""s,
+		        "a"s,
+		        "a\0"s,
+		        "a\0\0"s,
+		        "ab"s,
+		        "abcdefgh"s,
+		        "abcdefgh\0"s,
+		        "abcdefghi"s,
+		        "abcdefghij"s,
+		        "abcdefgi"s,
+		        "abcdefgh-a-long-identifier"s,
+		        "abcdefgh-a-long-identifies"s,
+		        "\x7f"s,
+		        "\x80"s,
+		        "\xff\xff\xff\xff\xff\xff\xff\xff"s,
+		        "\xff\xff\xff\xff\xff\xff\xff\xff\x01"s,
+		        "z"s};
+	}
+} // namespace
+
+TEST_CASE("prefixes order strings as std::string does") {
+	auto values = awkward_strings();
+	for (auto const& x : values) {
+		for (auto const& y : values) {
+			auto const c = gdwg::detail::key_prefix<std::string>(x).compare(
+			   gdwg::detail::key_prefix<std::string>(y));
+			if (c < 0) {
+				CHECK(x < y);
+			}
+			if (c > 0) {
+				CHECK(x > y);
+			}
+		}
+	}
+	CHECK(gdwg::detail::key_prefix<int>(3).compare(gdwg::detail::key_prefix<int>(4)) == 0);
+
+	auto g = gdwg::graph<std::string, int>(values.rbegin(), values.rend());
+	std::sort(values.begin(), values.end());
+	CHECK(g.nodes() == values);
+	for (auto const& v : values) {
+		CHECK(g.is_node(v));
+	}
+	CHECK(!g.is_node("abcdefg"));
+	CHECK(!g.is_node(std::string("abcdefgh\0\0", 10)));
+}
+
+TEST_CASE("edges between strings with shared prefixes") {
+	auto const values = awkward_strings();
+	auto g = gdwg::graph<std::string, int>(values.begin(), values.end());
+	auto expected = std::vector<std::tuple<std::string, std::string, int>>{};
+	for (auto i = std::size_t{0}; i < values.size(); ++i) {
+		for (auto j = std::size_t{0}; j < values.size(); j += 3) {
+			auto const& from = values[(i * 7) % values.size()];
+			auto const& to = values[(j * 5 + i) % values.size()];
+			if (g.insert_edge(from, to, static_cast<int>(j % 2))) {
+				expected.emplace_back(from, to, static_cast<int>(j % 2));
+			}
+		}
+	}
+	std::sort(expected.begin(), expected.end());
+	auto seen = std::vector<std::tuple<std::string, std::string, int>>{};
+	for (auto const& [from, to, weight] : g) {
+		seen.emplace_back(from, to, weight);
+	}
+	CHECK(seen == expected);
+	for (auto const& [from, to, weight] : expected) {
+		CHECK(g.is_connected(from, to));
+		CHECK(g.find(from, to, weight) != g.end());
+	}
+
+	SECTION("renaming a node reorders its edges by the new prefix") {
+		g.replace_node("abcdefghi", "0-first");
+		g.replace_node("a", "zz-last");
+		auto const connections = g.connections("0-first");
+		CHECK(std::is_sorted(connections.begin(), connections.end()));
+		auto renamed = std::vector<std::tuple<std::string, std::string, int>>{};
+		for (auto [from, to, weight] : expected) {
+			for (auto* end : {&from, &to}) {
+				*end = *end == "abcdefghi" ? "0-first" : (*end == "a" ? "zz-last" : *end);
+			}
+			renamed.emplace_back(from, to, weight);
+		}
+		std::sort(renamed.begin(), renamed.end());
+		seen.clear();
+		for (auto const& [from, to, weight] : g) {
+			seen.emplace_back(from, to, weight);
+		}
+		CHECK(seen == renamed);
+		CHECK(g.is_connected(std::get<0>(renamed.front()), std::get<1>(renamed.front())));
+	}
+	SECTION("merging into a node with a shared prefix") {
+		g.merge_replace_node("abcdefghij", "abcdefghi");
+		CHECK(!g.is_node("abcdefghij"));
+		auto const copy = g;
+		CHECK(copy == g);
+		CHECK(g.diff(copy).empty());
+	}
+}
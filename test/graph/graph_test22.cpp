@@ -0,0 +1,119 @@
+#include "gdwg/compressed_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// ======================
+// COMPRESSED WEIGHT RUNS
+// ----------------------
+
+namespace {
+	template<typename Range>
+	auto values(Range const& range) {
+		using value = std::remove_cvref_t<decltype(*range.begin())>;
+		return std::vector<value>(range.begin(), range.end());
+	}
+
+	// every pair of 50 nodes in a ring of 8 neighbours, with 40 weights each
+	auto multigraph() -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 50; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 50; ++i) {
+			for (auto k = 1; k <= 8; ++k) {
+				for (auto w = 0; w < 40; ++w) {
+					g.insert_edge(i, (i + k) % 50, 1000 * k + 3 * w);
+				}
+			}
+		}
+		return g;
+	}
+} // namespace
+
+static_assert(gdwg::compressed_graph<int, int>::weights_are_delta_coded);
+static_assert(gdwg::compressed_graph<std::string, std::uint8_t>::weights_are_delta_coded);
+static_assert(!gdwg::compressed_graph<int, bool>::weights_are_delta_coded);
+static_assert(!gdwg::compressed_graph<int, double>::weights_are_delta_coded);
+
+TEST_CASE("runs hold the weights of parallel edges") {
+	auto const g = multigraph();
+	auto const c = gdwg::compressed_graph(g.freeze());
+	CHECK(c.size() == 50);
+	CHECK(c.edge_count() == 50 * 8 * 40);
+	CHECK(c.pair_count() == 50 * 8);
+	for (auto const from : g.nodes()) {
+		auto const id = c.id(from);
+		CHECK(c.out_pairs(id).size() == 8);
+		for (auto const to : g.connections(from)) {
+			auto const run = c.weights(id, c.id(to));
+			CHECK(values(run) == g.weights(from, to));
+			CHECK(run.size() == 40);
+			CHECK(c.is_connected(id, c.id(to)));
+		}
+	}
+	CHECK(c.weights(c.id(0), c.id(0)).empty());
+	CHECK(!c.is_connected(c.id(0), c.id(0)));
+	CHECK_THROWS_AS(c.id(50), std::runtime_error);
+
+	// endpoints once a pair and about a byte a weight, against 40 edges in the tree
+	auto const compressed = c.memory_usage().total();
+	CHECK(5 * compressed < g.memory_usage().total());
+	CHECK(compressed < g.freeze().edge_count() * (sizeof(int) + sizeof(gdwg::node_id)) / 4);
+}
+
+TEST_CASE("delta coding keeps extreme and negative weights") {
+	auto g = gdwg::graph<char, std::int64_t>{'a', 'b', 'c'};
+	auto const weights = std::vector<std::int64_t>{std::numeric_limits<std::int64_t>::min(),
+	                                               -300,
+	                                               -1,
+	                                               0,
+	                                               1,
+	                                               127,
+	                                               128,
+	                                               std::numeric_limits<std::int64_t>::max()};
+	for (auto const w : weights) {
+		g.insert_edge('a', 'b', w);
+	}
+	g.insert_edge('b', 'c', -5);
+	auto const c = gdwg::compressed_graph(g.freeze());
+	CHECK(values(c.weights(c.id('a'), c.id('b'))) == weights);
+	CHECK(values(c.weights(c.id('b'), c.id('c'))) == std::vector<std::int64_t>{-5});
+
+	auto u = gdwg::graph<int, std::uint16_t>{1, 2};
+	for (auto const w : {std::uint16_t{0}, std::uint16_t{1}, std::uint16_t{65535}}) {
+		u.insert_edge(1, 2, w);
+	}
+	auto const cu = gdwg::compressed_graph(u.freeze());
+	CHECK(values(cu.run(0)) == std::vector<std::uint16_t>{0, 1, 65535});
+}
+
+TEST_CASE("unsorted and permuted snapshots are grouped into runs") {
+	// the same pair split up, and weights out of order
+	auto const frozen = gdwg::frozen_graph<std::string, double>({"x", "y", "z"},
+	                                                           {0, 5, 5, 6},
+	                                                           {1, 2, 1, 1, 2, 0},
+	                                                           {2.5, 1.0, -1.0, 2.5, 0.5, 7.0});
+	auto const c = gdwg::compressed_graph(frozen);
+	CHECK(c.edge_count() == 6);
+	CHECK(c.pair_count() == 3);
+	CHECK(values(c.weights(0, 1)) == std::vector<double>{-1.0, 2.5, 2.5});
+	CHECK(values(c.weights(0, 2)) == std::vector<double>{0.5, 1.0});
+	CHECK(values(c.weights(2, 0)) == std::vector<double>{7.0});
+	CHECK(c.out_pairs(1).empty());
+
+	auto const g = multigraph();
+	auto reversed = std::vector<gdwg::node_id>(50);
+	for (auto i = gdwg::node_id{0}; i < 50; ++i) {
+		reversed[i] = 49 - i;
+	}
+	auto const permuted = gdwg::compressed_graph(g.freeze().permute(reversed));
+	CHECK(permuted.node(0) == 49);
+	CHECK(permuted.id(49) == 0);
+	CHECK(values(permuted.weights(permuted.id(3), permuted.id(5))) == g.weights(3, 5));
+	CHECK(gdwg::compressed_graph<int, int>{}.edge_count() == 0);
+}
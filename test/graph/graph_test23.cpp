@@ -0,0 +1,70 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ==========
+// EDGE SCANS
+// ----------
+
+namespace {
+	template<typename N, typename E>
+	auto iterated(gdwg::graph<N, E> const& g) -> std::vector<std::tuple<N, N, E>> {
+		auto result = std::vector<std::tuple<N, N, E>>{};
+		for (auto const& [from, to, weight] : g) {
+			result.emplace_back(from, to, weight);
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto scanned(gdwg::graph<N, E> const& g) -> std::vector<std::tuple<N, N, E>> {
+		auto result = std::vector<std::tuple<N, N, E>>{};
+		g.for_each_edge([&](N const& from, N const& to, E const& weight) {
+			result.emplace_back(from, to, weight);
+		});
+		return result;
+	}
+} // namespace
+
+TEST_CASE("for_each_edge visits the edges in iterator order") {
+	SECTION("inline edges") {
+		auto g = gdwg::graph<int, int>{};
+		CHECK(scanned(g).empty());
+		for (auto i = 0; i < 100; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 100; ++i) {
+			g.insert_edge(i, (i * 37) % 100, i % 3);
+			g.insert_edge((i * 11) % 100, i, 5);
+		}
+		CHECK(scanned(g) == iterated(g));
+		CHECK(scanned(g).size() == 200);
+	}
+	SECTION("shared edges, fewer and more than are prefetched ahead") {
+		for (auto const size : {1, 3, 16, 17, 40, 500}) {
+			auto g = gdwg::graph<std::string, std::string>{};
+			for (auto i = 0; i < size; ++i) {
+				g.insert_node(std::to_string(i));
+			}
+			for (auto i = 0; i < size; ++i) {
+				g.insert_edge(std::to_string(i), std::to_string((i * 7) % size), "w");
+			}
+			CHECK(scanned(g) == iterated(g));
+			CHECK(scanned(g).size() == static_cast<std::size_t>(size));
+		}
+	}
+}
+
+TEST_CASE("the callback may query the graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 2);
+	auto reachable = 0;
+	g.for_each_edge([&](std::string const& from, std::string const& to, int) {
+		reachable += g.is_connected(from, to) ? 1 : 0;
+	});
+	CHECK(reachable == 2);
+}
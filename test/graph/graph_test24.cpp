@@ -0,0 +1,134 @@
+#include "gdwg/async_queries.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============
+// ASYNC QUERIES
+// -------------
+
+namespace {
+	// a coroutine that starts at once and that nobody waits on, as a request handler would be
+	struct detached {
+		struct promise_type {
+			auto get_return_object() noexcept -> detached {
+				return {};
+			}
+			auto initial_suspend() noexcept -> std::suspend_never {
+				return {};
+			}
+			auto final_suspend() noexcept -> std::suspend_never {
+				return {};
+			}
+			auto return_void() noexcept -> void {}
+			auto unhandled_exception() noexcept -> void {
+				std::terminate();
+			}
+		};
+	};
+
+	auto grid(int size) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < size * size; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < size * size; ++i) {
+			if ((i + 1) % size != 0) {
+				g.insert_edge(i, i + 1, i % 5);
+				g.insert_edge(i, i + 1, 7);
+			}
+			if (i + size < size * size) {
+				g.insert_edge(i, i + size, 1);
+			}
+		}
+		return g;
+	}
+
+	auto connections_of(gdwg::query_batcher<int, int>& q, int src, std::vector<int>& out)
+	   -> detached {
+		out = co_await q.async_connections(src);
+	}
+
+	// the weights to each neighbour, found with a second query once the first has come back
+	auto two_hops(gdwg::query_batcher<int, int>& q, int src, std::vector<std::vector<int>>& out)
+	   -> detached {
+		auto const neighbours = co_await q.async_connections(src);
+		for (auto const to : neighbours) {
+			out.push_back(co_await q.async_weights(src, to));
+		}
+	}
+} // namespace
+
+TEST_CASE("queries are resolved a batch at a time") {
+	auto const g = grid(10);
+	auto q = gdwg::query_batcher<int, int>(g);
+
+	auto results = std::vector<std::vector<int>>(100);
+	for (auto i = 99; i >= 0; --i) {
+		connections_of(q, i, results[static_cast<std::size_t>(i)]);
+	}
+	CHECK(q.pending() == 100);
+	CHECK(results[0].empty());
+	CHECK(q.run_pending() == 100);
+	CHECK(q.pending() == 0);
+	for (auto i = 0; i < 100; ++i) {
+		CHECK(results[static_cast<std::size_t>(i)] == g.connections(i));
+	}
+
+	auto weights = std::vector<std::vector<int>>{};
+	two_hops(q, 0, weights);
+	CHECK(q.run_pending() == 1);
+	CHECK(q.pending() == 1); // one neighbour at a time
+	auto expected = std::vector<std::vector<int>>{};
+	for (auto const to : g.connections(0)) {
+		expected.push_back(g.weights(0, to));
+	}
+	CHECK(q.run() == expected.size());
+	CHECK(weights == expected);
+}
+
+TEST_CASE("repeated and failing queries") {
+	auto const g = gdwg::graph<std::string, int>{"a", "b"};
+	auto q = gdwg::query_batcher<std::string, int>(g);
+	auto answers = std::vector<bool>{};
+	auto errors = 0;
+	auto ask = [&](std::string src, std::string dst) -> detached {
+		try {
+			answers.push_back(co_await q.async_is_connected(std::move(src), std::move(dst)));
+		} catch (std::runtime_error const&) {
+			++errors;
+		}
+	};
+	for (auto i = 0; i < 3; ++i) {
+		ask("a", "b");
+		ask("a", "missing");
+	}
+	CHECK(q.run() == 6);
+	CHECK(answers == std::vector<bool>{false, false, false});
+	CHECK(errors == 3);
+}
+
+TEST_CASE("large batches are resolved on the thread pool") {
+	auto const g = grid(60);
+	auto q = gdwg::query_batcher<int, int>(g);
+	auto const queries = 3 * gdwg::query_batcher<int, int>::parallel_batch;
+	auto connected = std::vector<int>(queries, -1);
+	auto check = [&](std::size_t i) -> detached {
+		auto const src = static_cast<int>(i % 3600);
+		auto const result = co_await q.async_is_connected(src, (src + 1) % 3600);
+		connected[i] = result ? 1 : 0;
+	};
+	for (auto i = std::size_t{0}; i < queries; ++i) {
+		check(i);
+	}
+	CHECK(q.run_pending() == queries);
+	for (auto i = std::size_t{0}; i < queries; ++i) {
+		auto const src = static_cast<int>(i % 3600);
+		CHECK(connected[i] == (g.is_connected(src, (src + 1) % 3600) ? 1 : 0));
+	}
+}
@@ -0,0 +1,160 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// ===========
+// QUERY CACHE
+// -----------
+
+namespace {
+	// every answer connections and weights give, with an empty result for a throw
+	auto answers(gdwg::graph<int, int> const& g, int range)
+	   -> std::vector<std::pair<std::vector<int>, bool>> {
+		auto result = std::vector<std::pair<std::vector<int>, bool>>{};
+		for (auto from = 0; from < range; ++from) {
+			try {
+				result.emplace_back(g.connections(from), true);
+			} catch (std::runtime_error const&) {
+				result.emplace_back(std::vector<int>{}, false);
+			}
+			for (auto to = 0; to < range; ++to) {
+				try {
+					result.emplace_back(g.weights(from, to), true);
+				} catch (std::runtime_error const&) {
+					result.emplace_back(std::vector<int>{}, false);
+				}
+			}
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("cached answers follow every modifier") {
+	auto plain = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 8; ++i) {
+		plain.insert_node(i);
+	}
+	auto cached = plain;
+	cached.enable_query_cache(16);
+	CHECK(cached.has_query_cache());
+	CHECK(!plain.has_query_cache());
+
+	auto random = std::mt19937{7};
+	auto pick = [&random] { return static_cast<int>(random() % 10); };
+	for (auto step = 0; step < 400; ++step) {
+		auto const a = pick();
+		auto const b = pick();
+		auto const w = pick() % 3;
+		for (auto* g : {&plain, &cached}) {
+			try {
+				switch (step % 7) {
+				case 0:
+				case 1: g->insert_edge(a, b, w); break;
+				case 2: g->erase_edge(a, b, w); break;
+				case 3: g->insert_node(a); break;
+				case 4:
+					if (step % 5 == 0) {
+						g->erase_node(a);
+					}
+					else {
+						g->insert_edge(b, a, w);
+					}
+					break;
+				case 5: g->replace_node(a, b); break;
+				default: g->merge_replace_node(a, b); break;
+				}
+			} catch (std::runtime_error const&) {
+			}
+		}
+		REQUIRE(cached == plain);
+		REQUIRE(answers(cached, 10) == answers(plain, 10));
+	}
+	auto const counts = cached.query_cache_counts();
+	CHECK(counts.hits > 0);
+	CHECK(counts.misses > 0);
+	CHECK(counts.evictions > 0);
+	CHECK(counts.invalidations > 0);
+	CHECK(counts.size <= 2 * counts.capacity);
+	CHECK(counts.capacity == 16);
+
+	for (auto* g : {&plain, &cached}) {
+		auto first = g->find(2, 0, 0) != g->end() ? g->find(2, 0, 0) : g->begin();
+		auto last = g->end();
+		g->erase_edge(first, last);
+	}
+	CHECK(answers(cached, 10) == answers(plain, 10));
+	cached.clear();
+	CHECK(cached.query_cache_counts().size == 0);
+}
+
+TEST_CASE("hits, misses and CLOCK eviction") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5, 6};
+	g.insert_edge(1, 2, 1);
+	g.enable_query_cache(3);
+	CHECK(g.connections(1) == std::vector<int>{2});
+	CHECK(g.connections(1) == std::vector<int>{2});
+	CHECK(g.weights(1, 2) == std::vector<int>{1});
+	auto counts = g.query_cache_counts();
+	CHECK(counts.hits == 1);
+	CHECK(counts.misses == 2);
+	CHECK(counts.hit_rate() == Approx(1.0 / 3.0));
+
+	// node 1 is asked for again between the others, so it is never the one evicted
+	for (auto n = 2; n <= 6; ++n) {
+		static_cast<void>(g.connections(n));
+		static_cast<void>(g.connections(1));
+	}
+	counts = g.query_cache_counts();
+	CHECK(counts.hits == 1 + 5);
+	CHECK(counts.evictions == 3);
+	CHECK(counts.size == 3 + 1);
+
+	g.insert_edge(3, 1, 0); // changes connections(3) only
+	counts = g.query_cache_counts();
+	static_cast<void>(g.connections(1));
+	CHECK(g.query_cache_counts().hits == counts.hits + 1);
+	CHECK(g.memory_usage().payload > 0);
+
+	auto copy = g;
+	CHECK(copy.has_query_cache());
+	CHECK(copy.query_cache_counts().size == 0);
+	auto moved = std::move(copy);
+	CHECK(moved.has_query_cache());
+	g.disable_query_cache();
+	CHECK(g.query_cache_counts() == gdwg::query_cache_stats{});
+}
+
+TEST_CASE("cached lookups from several threads") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 50; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 50; ++i) {
+		g.insert_edge(i, (i * 7) % 50, i);
+	}
+	g.enable_query_cache(20);
+	auto threads = std::vector<std::thread>{};
+	auto failures = std::vector<int>(4, 0);
+	for (auto t = 0; t < 4; ++t) {
+		threads.emplace_back([&g, &failures, t] {
+			for (auto i = 0; i < 2000; ++i) {
+				auto const n = (i * (t + 3)) % 50;
+				if (g.connections(n) != std::vector<int>{(n * 7) % 50}
+				    or g.weights(n, (n * 7) % 50) != std::vector<int>{n})
+				{
+					++failures[static_cast<std::size_t>(t)];
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	CHECK(failures == std::vector<int>(4, 0));
+	auto const counts = g.query_cache_counts();
+	CHECK(counts.hits + counts.misses == 4 * 2000 * 2);
+}
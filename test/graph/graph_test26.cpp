@@ -0,0 +1,203 @@
+#include "gdwg/algorithms/shortest_paths.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============================
+// POINT-TO-POINT SHORTEST PATHS
+// -----------------------------
+
+namespace {
+	using gdwg::node_id;
+	constexpr auto unreachable = std::numeric_limits<int>::max();
+
+	// plain Dijkstra from src over the whole graph
+	auto distances(gdwg::frozen_graph<int, int> const& g, node_id src) -> std::vector<int> {
+		auto result = std::vector<int>(g.size(), unreachable);
+		using entry = std::pair<int, node_id>;
+		auto heap = std::priority_queue<entry, std::vector<entry>, std::greater<>>{};
+		result[src] = 0;
+		heap.emplace(0, src);
+		while (!heap.empty()) {
+			auto const [d, v] = heap.top();
+			heap.pop();
+			if (d != result[v]) {
+				continue;
+			}
+			auto const targets = g.out_edges(v);
+			auto const weights = g.out_weights(v);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				if (d + weights[i] < result[targets[i]]) {
+					result[targets[i]] = d + weights[i];
+					heap.emplace(result[targets[i]], targets[i]);
+				}
+			}
+		}
+		return result;
+	}
+
+	// the lightest edge from -> to, or unreachable if there is none
+	auto lightest(gdwg::frozen_graph<int, int> const& g, node_id from, node_id to) -> int {
+		auto result = unreachable;
+		auto const targets = g.out_edges(from);
+		for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+			if (targets[i] == to) {
+				result = std::min(result, g.out_weights(from)[i]);
+			}
+		}
+		return result;
+	}
+
+	auto check_path(gdwg::frozen_graph<int, int> const& g,
+	                gdwg::algorithms::path_result<int> const& found,
+	                node_id src,
+	                node_id dst,
+	                int expected) -> void {
+		REQUIRE(found.found == (expected != unreachable));
+		if (!found.found) {
+			return;
+		}
+		CHECK(found.distance == expected);
+		REQUIRE(!found.nodes.empty());
+		CHECK(found.nodes.front() == src);
+		CHECK(found.nodes.back() == dst);
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < found.nodes.size(); ++i) {
+			auto const w = lightest(g, found.nodes[i - 1], found.nodes[i]);
+			REQUIRE(w != unreachable);
+			total += w;
+		}
+		CHECK(total == expected);
+	}
+
+	// a size x size grid with edges both ways between neighbours, weighing at least 1 each
+	auto grid(int size, std::mt19937& random) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < size * size; ++i) {
+			g.insert_node(i);
+		}
+		auto weight = [&random] { return 1 + static_cast<int>(random() % 4); };
+		for (auto i = 0; i < size * size; ++i) {
+			if ((i + 1) % size != 0) {
+				g.insert_edge(i, i + 1, weight());
+				g.insert_edge(i + 1, i, weight());
+			}
+			if (i + size < size * size) {
+				g.insert_edge(i, i + size, weight());
+				g.insert_edge(i + size, i, weight());
+			}
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("both searches agree with Dijkstra on every pair") {
+	auto random = std::mt19937{11};
+	for (auto const density : {1, 3}) {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 60; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 60 * density; ++i) {
+			g.insert_edge(static_cast<int>(random() % 60),
+			              static_cast<int>(random() % 60),
+			              static_cast<int>(random() % 20));
+		}
+		auto const frozen = g.freeze();
+		auto search = gdwg::algorithms::path_search<int, int>(frozen);
+		auto const no_estimate = [](node_id) { return 0; };
+		for (auto src = node_id{0}; src < frozen.size(); ++src) {
+			auto const expected = distances(frozen, src);
+			for (auto dst = node_id{0}; dst < frozen.size(); ++dst) {
+				check_path(frozen, search.bidirectional_dijkstra(src, dst), src, dst, expected[dst]);
+				check_path(frozen, search.a_star(src, dst, no_estimate), src, dst, expected[dst]);
+			}
+		}
+	}
+}
+
+TEST_CASE("A* with a consistent estimate settles fewer nodes") {
+	auto random = std::mt19937{5};
+	auto const g = grid(30, random);
+	auto const frozen = g.freeze();
+	auto search = gdwg::algorithms::path_search<int, int>(frozen);
+	auto const src = frozen.id(0);
+	auto const dst = frozen.id(30 * 30 - 1);
+	auto const manhattan = [&](node_id v) {
+		auto const n = frozen.node(v);
+		return std::abs(n % 30 - 29) + std::abs(n / 30 - 29);
+	};
+	auto const expected = distances(frozen, src)[dst];
+
+	auto const guided = search.a_star(src, dst, manhattan);
+	check_path(frozen, guided, src, dst, expected);
+	auto const guided_settled = guided.settled;
+	auto const blind = search.a_star(src, dst, [](node_id) { return 0; });
+	check_path(frozen, blind, src, dst, expected);
+	CHECK(guided_settled < blind.settled);
+
+	// the meeting point is near the middle, so each side settles about half the grid
+	auto const both = search.bidirectional_dijkstra(src, dst);
+	check_path(frozen, both, src, dst, expected);
+	CHECK(both.settled < blind.settled);
+}
+
+TEST_CASE("edge cases") {
+	SECTION("a node to itself, an unreachable node and bad ids") {
+		auto const g = gdwg::graph<int, int>{1, 2, 3};
+		auto const frozen = g.freeze();
+		auto search = gdwg::algorithms::path_search<int, int>(frozen);
+		auto const self = search.bidirectional_dijkstra(0, 0);
+		CHECK(self.found);
+		CHECK(self.distance == 0);
+		CHECK(std::vector<node_id>(self.nodes.begin(), self.nodes.end()) == std::vector<node_id>{0});
+		CHECK(!search.bidirectional_dijkstra(0, 1).found);
+		CHECK(!search.a_star(0, 1, [](node_id) { return 0; }).found);
+		CHECK_THROWS_AS(search.bidirectional_dijkstra(0, 3), std::out_of_range);
+	}
+	SECTION("negative weights are refused") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		auto const frozen = g.freeze();
+		using search = gdwg::algorithms::path_search<int, int>;
+		CHECK_THROWS_AS(search(frozen), std::invalid_argument);
+	}
+	SECTION("shortest_path on node values") {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1.5);
+		g.insert_edge("b", "d", 1.0);
+		g.insert_edge("a", "c", 0.5);
+		g.insert_edge("c", "d", 3.0);
+		g.insert_edge("a", "d", 2.75);
+		auto const path = gdwg::algorithms::shortest_path(g, std::string("a"), std::string("d"));
+		REQUIRE(path.has_value());
+		CHECK(*path == gdwg::algorithms::weighted_path<std::string, double>{2.5, {"a", "b", "d"}});
+		CHECK(!gdwg::algorithms::shortest_path(g, std::string("d"), std::string("a")).has_value());
+		CHECK_THROWS_AS(gdwg::algorithms::shortest_path(g, std::string("a"), std::string("e")),
+		                std::runtime_error);
+	}
+}
+
+TEST_CASE("back-to-back queries reuse the search state") {
+	auto random = std::mt19937{3};
+	auto const g = grid(12, random);
+	auto const frozen = g.freeze();
+	auto search = gdwg::algorithms::path_search<int, int>(frozen);
+	auto expected = std::vector<std::vector<int>>{};
+	for (auto src = node_id{0}; src < frozen.size(); ++src) {
+		expected.push_back(distances(frozen, src));
+	}
+	for (auto i = 0; i < 3000; ++i) {
+		auto const src = static_cast<node_id>(random() % frozen.size());
+		auto const dst = static_cast<node_id>(random() % frozen.size());
+		check_path(frozen, search.bidirectional_dijkstra(src, dst), src, dst, expected[src][dst]);
+	}
+}
@@ -0,0 +1,118 @@
+#include "gdwg/algorithms/all_pairs.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ========================
+// ALL-PAIRS SHORTEST PATHS
+// ------------------------
+
+namespace {
+	using gdwg::algorithms::all_pairs_shortest_paths;
+	using gdwg::algorithms::apsp_algorithm;
+	using gdwg::algorithms::distance_matrix;
+
+	// textbook Floyd-Warshall, one k at a time
+	template<typename E>
+	auto reference(gdwg::frozen_graph<int, E> const& g) -> distance_matrix<E> {
+		constexpr auto unreachable = distance_matrix<E>::unreachable;
+		auto const n = g.size();
+		auto d = distance_matrix<E>{n, std::vector<E>(n * n, unreachable)};
+		for (auto from = gdwg::node_id{0}; from < n; ++from) {
+			d.distance[from * n + from] = E{};
+			auto const targets = g.out_edges(from);
+			auto const weights = g.out_weights(from);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				auto& cell = d.distance[from * n + targets[i]];
+				cell = std::min(cell, weights[i]);
+			}
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					auto const ik = d.distance[i * n + k];
+					auto const kj = d.distance[k * n + j];
+					if (ik != unreachable and kj != unreachable and ik + kj < d.distance[i * n + j]) {
+						d.distance[i * n + j] = ik + kj;
+					}
+				}
+			}
+		}
+		return d;
+	}
+
+	// a random graph with parallel edges and self loops. With potentials, each weight is shifted
+	// by p(from) - p(to) for random p, which makes some negative but keeps every cycle's total.
+	auto random_graph(int nodes, int edges, bool potentials, std::mt19937& random)
+	   -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		auto p = std::vector<int>(static_cast<std::size_t>(nodes));
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+			p[static_cast<std::size_t>(i)] = potentials ? static_cast<int>(random() % 50) : 0;
+		}
+		for (auto i = 0; i < edges; ++i) {
+			auto const from = static_cast<int>(random() % static_cast<unsigned>(nodes));
+			auto const to = static_cast<int>(random() % static_cast<unsigned>(nodes));
+			auto const shift = p[static_cast<std::size_t>(from)] - p[static_cast<std::size_t>(to)];
+			g.insert_edge(from, to, static_cast<int>(random() % 30) + shift);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("both algorithms agree with plain Floyd-Warshall") {
+	auto random = std::mt19937{17};
+	// sizes either side of a whole number of tiles, so the padding is exercised
+	for (auto const nodes : {1, 2, 63, 64, 65, 130}) {
+		for (auto const density : {1, 4, 20}) {
+			for (auto const potentials : {false, true}) {
+				auto const g = random_graph(nodes, nodes * density, potentials, random);
+				auto const frozen = g.freeze();
+				auto const expected = reference(frozen);
+				auto const fw = all_pairs_shortest_paths(frozen, apsp_algorithm::floyd_warshall);
+				auto const johnson = all_pairs_shortest_paths(frozen, apsp_algorithm::johnson);
+				REQUIRE(fw == expected);
+				REQUIRE(johnson == expected);
+				CHECK(all_pairs_shortest_paths(g) == expected);
+			}
+		}
+	}
+	CHECK(all_pairs_shortest_paths(gdwg::graph<int, int>{}).size == 0);
+}
+
+TEST_CASE("floating point weights and node values") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1.5);
+	g.insert_edge("a", "b", 0.25);
+	g.insert_edge("b", "c", -0.5);
+	g.insert_edge("c", "a", 2.0);
+	g.insert_edge("a", "c", 4.0);
+	for (auto const algorithm : {apsp_algorithm::floyd_warshall, apsp_algorithm::johnson}) {
+		auto const d = all_pairs_shortest_paths(g, algorithm);
+		REQUIRE(d.size == 4);
+		CHECK(d(0, 1) == 0.25);
+		CHECK(d(0, 2) == -0.25);
+		CHECK(d(2, 1) == 2.25);
+		CHECK(d(1, 0) == 1.5);
+		CHECK(d(3, 3) == 0.0);
+		CHECK(!d.reachable(0, 3));
+		CHECK(!d.reachable(3, 0));
+		CHECK(d(0, 3) == distance_matrix<double>::unreachable);
+	}
+}
+
+TEST_CASE("a negative cycle is refused") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 4);
+	g.insert_edge(2, 3, -3);
+	g.insert_edge(3, 1, -2);
+	CHECK_THROWS_AS(all_pairs_shortest_paths(g), std::invalid_argument);
+	auto loop = gdwg::graph<int, int>{1};
+	loop.insert_edge(1, 1, -1);
+	CHECK_THROWS_AS(all_pairs_shortest_paths(loop), std::invalid_argument);
+}
@@ -0,0 +1,140 @@
+#include "gdwg/algorithms/triangles.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// =========
+// TRIANGLES
+// ---------
+
+namespace {
+	using gdwg::algorithms::clustering_coefficients;
+	using gdwg::algorithms::triangle_count;
+
+	struct expected_triangles {
+		std::uint64_t total = 0;
+		std::vector<double> clustering{};
+	};
+
+	// every triple u < v < w of an undirected copy of the graph, checked pair by pair
+	auto brute_force(gdwg::frozen_graph<int, int> const& g) -> expected_triangles {
+		auto const n = g.size();
+		auto adjacent = std::vector<std::set<gdwg::node_id>>(n);
+		for (auto from = gdwg::node_id{0}; from < n; ++from) {
+			for (auto const to : g.out_edges(from)) {
+				if (to != from) {
+					adjacent[from].insert(to);
+					adjacent[to].insert(from);
+				}
+			}
+		}
+		auto per_node = std::vector<std::uint64_t>(n, 0);
+		auto result = expected_triangles{};
+		for (auto u = gdwg::node_id{0}; u < n; ++u) {
+			for (auto const v : adjacent[u]) {
+				for (auto const w : adjacent[v]) {
+					if (u < v and v < w and adjacent[u].contains(w)) {
+						++result.total;
+						++per_node[u];
+						++per_node[v];
+						++per_node[w];
+					}
+				}
+			}
+		}
+		for (auto v = gdwg::node_id{0}; v < n; ++v) {
+			auto const d = static_cast<double>(adjacent[v].size());
+			auto const pairs = d * (d - 1.0) / 2.0;
+			result.clustering.push_back(pairs == 0.0 ? 0.0 : static_cast<double>(per_node[v]) / pairs);
+		}
+		return result;
+	}
+
+	auto random_graph(int nodes, int edges, std::mt19937& random) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < edges; ++i) {
+			g.insert_edge(static_cast<int>(random() % static_cast<unsigned>(nodes)),
+			              static_cast<int>(random() % static_cast<unsigned>(nodes)),
+			              i % 3);
+		}
+		return g;
+	}
+
+	auto check(gdwg::graph<int, int> const& g) -> void {
+		auto const frozen = g.freeze();
+		auto const expected = brute_force(frozen);
+		CHECK(triangle_count(frozen) == expected.total);
+		auto const clustering = clustering_coefficients(frozen);
+		REQUIRE(clustering.size() == expected.clustering.size());
+		for (auto i = std::size_t{0}; i < clustering.size(); ++i) {
+			CHECK(clustering[i] == Approx(expected.clustering[i]));
+		}
+	}
+} // namespace
+
+TEST_CASE("counts match every triple checked by hand") {
+	auto random = std::mt19937{23};
+	SECTION("sparse and dense random graphs, with parallel edges and self loops") {
+		for (auto const [nodes, edges] : {std::pair{1, 3}, {30, 60}, {60, 600}, {80, 3000}}) {
+			check(random_graph(nodes, edges, random));
+		}
+	}
+	SECTION("a large graph, split into blocks over the pool") {
+		check(random_graph(3000, 80000, random));
+	}
+	SECTION("a clique, whose long lists are intersected through a hash set") {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 100; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 100; ++i) {
+			for (auto j = i + 1; j < 100; ++j) {
+				// both directions for some pairs, which must still count once
+				g.insert_edge((i + j) % 2 == 0 ? i : j, (i + j) % 2 == 0 ? j : i, 1);
+				if (j % 7 == 0) {
+					g.insert_edge(j, i, 2);
+				}
+			}
+		}
+		CHECK(triangle_count(g) == 100 * 99 * 98 / 6);
+		CHECK(clustering_coefficients(g) == std::vector<double>(100, 1.0));
+		check(g);
+	}
+}
+
+TEST_CASE("graphs with no triangles") {
+	CHECK(triangle_count(gdwg::graph<int, int>{}) == 0);
+	CHECK(clustering_coefficients(gdwg::graph<int, int>{}).empty());
+	auto bipartite = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 20; ++i) {
+		bipartite.insert_node(i);
+	}
+	for (auto i = 0; i < 10; ++i) {
+		for (auto j = 10; j < 20; ++j) {
+			bipartite.insert_edge(i, j, 0);
+		}
+	}
+	CHECK(triangle_count(bipartite) == 0);
+	CHECK(clustering_coefficients(bipartite) == std::vector<double>(20, 0.0));
+}
+
+TEST_CASE("clustering on string nodes") {
+	// a triangle a b c, with d hanging off c and e on its own
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1.0);
+	g.insert_edge("b", "c", 1.0);
+	g.insert_edge("c", "a", 1.0);
+	g.insert_edge("c", "d", 1.0);
+	g.insert_edge("d", "d", 1.0);
+	CHECK(triangle_count(g) == 1);
+	auto const c = clustering_coefficients(g);
+	CHECK(c == std::vector<double>{1.0, 1.0, 1.0 / 3.0, 0.0, 0.0});
+}
@@ -0,0 +1,119 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/thread_pool.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ===========
+// THREAD POOL
+// -----------
+
+TEST_CASE("thread_pool::parallel_for") {
+	SECTION("every index is visited exactly once") {
+		auto pool = gdwg::thread_pool(4);
+		CHECK(pool.size() == 4);
+		auto visits = std::vector<std::atomic<int>>(100000);
+		pool.parallel_for(visits.size(), [&](std::size_t first, std::size_t last) {
+			for (; first != last; ++first) {
+				++visits[first];
+			}
+		});
+		CHECK(ranges::all_of(visits, [](std::atomic<int> const& v) { return v.load() == 1; }));
+	}
+	SECTION("grain size bounds the pieces") {
+		auto pool = gdwg::thread_pool(3);
+		auto largest = std::atomic<std::size_t>{0};
+		auto covered = std::atomic<std::size_t>{0};
+		pool.parallel_for(
+		   1000,
+		   [&](std::size_t first, std::size_t last) {
+			   auto seen = largest.load();
+			   while (last - first > seen and !largest.compare_exchange_weak(seen, last - first)) {}
+			   covered += last - first;
+		   },
+		   10);
+		CHECK(largest.load() <= 10);
+		CHECK(covered.load() == 1000);
+	}
+	SECTION("empty range does nothing") {
+		auto pool = gdwg::thread_pool(2);
+		auto calls = std::atomic<int>{0};
+		pool.parallel_for(0, [&](std::size_t, std::size_t) { ++calls; });
+		CHECK(calls.load() == 0);
+	}
+	SECTION("nested calls from inside a task complete") {
+		auto pool = gdwg::thread_pool(2);
+		auto total = std::atomic<std::size_t>{0};
+		pool.parallel_for(
+		   8,
+		   [&](std::size_t first, std::size_t last) {
+			   for (; first != last; ++first) {
+				   pool.parallel_for(1000, [&](std::size_t f, std::size_t l) { total += l - f; });
+			   }
+		   },
+		   1);
+		CHECK(total.load() == 8000);
+	}
+	SECTION("an exception thrown by a task reaches the caller") {
+		auto pool = gdwg::thread_pool(4);
+		CHECK_THROWS_WITH(pool.parallel_for(1000,
+		                                    [](std::size_t first, std::size_t last) {
+			                                    if (first <= 500 and 500 < last) {
+				                                    throw std::runtime_error("task failed");
+			                                    }
+		                                    }),
+		                  "task failed");
+		// the pool is still usable afterwards
+		auto covered = std::atomic<std::size_t>{0};
+		pool.parallel_for(1000, [&](std::size_t f, std::size_t l) { covered += l - f; });
+		CHECK(covered.load() == 1000);
+	}
+}
+
+TEST_CASE("parallel_for_each_node and parallel_for_each_edge") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const v = std::vector<graph::value_type>{{"a", "b", 1},
+	                                              {"a", "c", 2},
+	                                              {"b", "c", 3},
+	                                              {"c", "a", 4},
+	                                              {"c", "a", 5},
+	                                              {"d", "d", 6}};
+	auto g = graph(v.begin(), v.end());
+	g.insert_node("e");
+	auto pool = gdwg::thread_pool(3);
+	auto mutex = std::mutex{};
+
+	SECTION("each node is visited once") {
+		auto seen = std::multiset<std::string>{};
+		gdwg::parallel_for_each_node(pool, g, [&](std::string const& n) {
+			auto const lock = std::scoped_lock(mutex);
+			seen.insert(n);
+		});
+		CHECK(seen == std::multiset<std::string>{"a", "b", "c", "d", "e"});
+	}
+	SECTION("each edge is visited once") {
+		// Catch2 assertions are not thread safe, so only count inside the tasks
+		auto weight_sum = std::atomic<int>{0};
+		auto edges = std::atomic<int>{0};
+		auto connected = std::atomic<int>{0};
+		gdwg::parallel_for_each_edge(pool, g, [&](graph::value_type const& e) {
+			connected += g.is_connected(e.from, e.to) ? 1 : 0;
+			weight_sum += e.weight;
+			++edges;
+		});
+		CHECK(edges.load() == 6);
+		CHECK(connected.load() == 6);
+		CHECK(weight_sum.load() == 21);
+	}
+	SECTION("empty graph") {
+		auto calls = std::atomic<int>{0};
+		gdwg::parallel_for_each_node(pool, graph{}, [&](std::string const&) { ++calls; });
+		gdwg::parallel_for_each_edge(pool, graph{}, [&](graph::value_type const&) { ++calls; });
+		CHECK(calls.load() == 0);
+	}
+}
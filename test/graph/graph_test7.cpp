@@ -0,0 +1,150 @@
+#include "gdwg/algorithms/components.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// ==========================================
+// FROZEN GRAPH AND CONNECTED COMPONENTS
+// ------------------------------------------
+
+TEST_CASE("graph::freeze") {
+	SECTION("CSR arrays follow node and edge order") {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{{"b", "a", 3},
+		                                              {"a", "c", 2},
+		                                              {"a", "b", 1},
+		                                              {"a", "b", 7},
+		                                              {"c", "c", 4}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("d");
+		auto const f = g.freeze();
+		CHECK(f.nodes() == g.nodes());
+		CHECK(f.size() == 4);
+		CHECK(f.edge_count() == 5);
+		CHECK(f.offsets() == std::vector<std::size_t>{0, 3, 4, 5, 5});
+		CHECK(f.targets() == std::vector<gdwg::node_id>{1, 1, 2, 0, 2});
+		CHECK(f.weights() == std::vector<int>{1, 7, 2, 3, 4});
+		CHECK(f.id("c") == 2);
+		CHECK(f.node(3) == "d");
+		CHECK(f.out_degree(f.id("d")) == 0);
+		CHECK_THROWS_WITH(f.id("z"),
+		                  "Cannot call gdwg::frozen_graph<N, E>::id on a node that doesn't exist in "
+		                  "the graph");
+	}
+	SECTION("transpose reverses every edge") {
+		using graph = gdwg::graph<int, int>;
+		auto const v = std::vector<graph::value_type>{{1, 2, 5}, {1, 3, 6}, {2, 3, 7}, {3, 1, 8}};
+		auto const f = graph(v.begin(), v.end()).freeze();
+		auto const t = f.transpose();
+		CHECK(t.offsets() == std::vector<std::size_t>{0, 1, 2, 4});
+		CHECK(t.targets() == std::vector<gdwg::node_id>{2, 0, 0, 1});
+		CHECK(t.weights() == std::vector<int>{8, 5, 6, 7});
+		CHECK(t.transpose() == f);
+	}
+	SECTION("empty graph") {
+		auto const f = gdwg::graph<int, int>{}.freeze();
+		CHECK(f.empty());
+		CHECK(f.edge_count() == 0);
+	}
+}
+
+TEST_CASE("Strongly connected components") {
+	SECTION("cycles are grouped and labels follow reverse topological order") {
+		// {1,2,3} -> {4,5} -> {6}, plus 7 on its own
+		using graph = gdwg::graph<int, int>;
+		auto const v = std::vector<graph::value_type>{{1, 2, 0},
+		                                              {2, 3, 0},
+		                                              {3, 1, 0},
+		                                              {3, 4, 0},
+		                                              {4, 5, 0},
+		                                              {5, 4, 0},
+		                                              {5, 6, 0}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node(7);
+		auto const c = gdwg::algorithms::scc(g);
+		REQUIRE(c.count == 4);
+		auto const& l = c.label;
+		CHECK((l[0] == l[1] and l[1] == l[2]));
+		CHECK(l[3] == l[4]);
+		CHECK(l[0] != l[3]);
+		CHECK(l[5] != l[3]);
+		CHECK(l[6] != l[0]);
+		for (auto const& e : v) {
+			CHECK(l[static_cast<std::size_t>(e.from - 1)] >= l[static_cast<std::size_t>(e.to - 1)]);
+		}
+	}
+	SECTION("self loops and parallel edges") {
+		using graph = gdwg::graph<char, double>;
+		auto const v =
+		   std::vector<graph::value_type>{{'a', 'a', 1.0}, {'a', 'b', 1.0}, {'a', 'b', 2.0}};
+		auto const c = gdwg::algorithms::scc(graph(v.begin(), v.end()));
+		CHECK(c.count == 2);
+	}
+	SECTION("a two million node path does not recurse") {
+		auto constexpr n = std::size_t{2000000};
+		auto nodes = std::vector<int>(n);
+		auto offsets = std::vector<std::size_t>(n + 1);
+		auto targets = std::vector<gdwg::node_id>(n);
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			nodes[i] = static_cast<int>(i);
+			offsets[i + 1] = i + 1;
+			targets[i] = static_cast<gdwg::node_id>((i + 1) % n); // closes into one big cycle
+		}
+		auto const f = gdwg::frozen_graph<int, int>(nodes, offsets, targets, std::vector<int>(n));
+		CHECK(gdwg::algorithms::scc(f).count == 1);
+		targets.back() = static_cast<gdwg::node_id>(n - 1); // now a path ending in a self loop
+		auto const p = gdwg::frozen_graph<int, int>(nodes, offsets, targets, std::vector<int>(n));
+		CHECK(gdwg::algorithms::scc(p).count == n);
+	}
+	SECTION("empty graph") {
+		CHECK(gdwg::algorithms::scc(gdwg::graph<int, int>{}).count == 0);
+	}
+}
+
+TEST_CASE("Weakly connected components") {
+	SECTION("edge direction is ignored and labels follow the smallest node") {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{{"b", "a", 1},
+		                                              {"c", "b", 1},
+		                                              {"e", "d", 1},
+		                                              {"f", "f", 1}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("g");
+		auto const c = gdwg::algorithms::wcc(g);
+		CHECK(c.count == 4);
+		CHECK(c.label == std::vector<gdwg::node_id>{0, 0, 0, 1, 1, 2, 3});
+	}
+	SECTION("many edges on a multi-threaded pool match a sequential union-find") {
+		using graph = gdwg::graph<int, int>;
+		auto v = std::vector<graph::value_type>{};
+		for (auto i = 0; i < 20000; ++i) {
+			v.push_back({(i * 7919) % 30000, (i * 104723) % 30011, i});
+		}
+		auto const f = graph(v.begin(), v.end()).freeze();
+		auto pool = gdwg::thread_pool(4);
+		auto const c = gdwg::algorithms::wcc(f, pool);
+
+		auto parent = std::vector<std::size_t>(f.size());
+		std::iota(parent.begin(), parent.end(), std::size_t{0});
+		auto find = [&](std::size_t x) {
+			while (parent[x] != x) {
+				x = parent[x];
+			}
+			return x;
+		};
+		for (auto const& e : v) {
+			parent[find(f.id(e.from))] = find(f.id(e.to));
+		}
+		auto same_partition = true;
+		auto expected_count = std::size_t{0};
+		for (auto i = std::size_t{0}; i < f.size(); ++i) {
+			expected_count += find(i) == i ? 1 : 0;
+			same_partition = same_partition and c.label[i] == c.label[find(i)];
+		}
+		CHECK(same_partition);
+		CHECK(c.count == expected_count);
+	}
+}
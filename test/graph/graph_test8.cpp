@@ -0,0 +1,181 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ==========================
+// DYNAMIC TOPOLOGICAL ORDER
+// --------------------------
+
+namespace {
+	// checks every edge of g goes forward in g.topo_order(), and that every node is in it once
+	template<typename N, typename E>
+	auto is_topological(gdwg::graph<N, E> const& g) -> bool {
+		auto const order = g.topo_order();
+		auto position = std::map<N, std::size_t>{};
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			position.emplace(order[i], i);
+		}
+		if (position.size() != order.size() or order.size() != g.nodes().size()) {
+			return false;
+		}
+		for (auto const& [from, to, weight] : g) {
+			if (position.at(from) >= position.at(to)) {
+				return false;
+			}
+		}
+		return true;
+	}
+} // namespace
+
+TEST_CASE("topological order 1 (enable_topological_order)") {
+	SECTION("enabling on a DAG gives a valid order") {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{{"shirt", "tie", 1},
+		                                              {"tie", "jacket", 1},
+		                                              {"trousers", "shoes", 1},
+		                                              {"trousers", "belt", 1},
+		                                              {"belt", "jacket", 1},
+		                                              {"socks", "shoes", 1}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("watch");
+		CHECK(!g.has_topological_order());
+		g.enable_topological_order();
+		CHECK(g.has_topological_order());
+		CHECK(is_topological(g));
+	}
+	SECTION("enabling on a graph with a cycle throws and leaves it disabled") {
+		using graph = gdwg::graph<int, int>;
+		auto const v = std::vector<graph::value_type>{{1, 2, 0}, {2, 3, 0}, {3, 1, 0}};
+		auto g = graph(v.begin(), v.end());
+		CHECK_THROWS_WITH(g.enable_topological_order(),
+		                  "Cannot call gdwg::graph<N, E>::enable_topological_order on a graph with "
+		                  "a cycle");
+		CHECK(!g.has_topological_order());
+	}
+	SECTION("topo_order without enabling throws") {
+		auto const g = gdwg::graph<int, int>{1, 2};
+		CHECK_THROWS_WITH(g.topo_order(),
+		                  "Cannot call gdwg::graph<N, E>::topo_order when no topological order is "
+		                  "being maintained");
+	}
+}
+
+TEST_CASE("topological order 2 (kept up to date by the modifiers)") {
+	using graph = gdwg::graph<int, double>;
+	auto g = graph{1, 2, 3, 4, 5};
+	g.enable_topological_order();
+
+	SECTION("edges against the current order are repaired") {
+		g.insert_edge(5, 1, 1.0);
+		g.insert_edge(4, 5, 1.0);
+		g.insert_edge(1, 2, 1.0);
+		g.insert_edge(3, 4, 1.0);
+		CHECK(is_topological(g));
+		CHECK(g.topo_order() == std::vector<int>{3, 4, 5, 1, 2});
+	}
+	SECTION("edges that close a cycle throw and change nothing") {
+		g.insert_edge(1, 2, 1.0);
+		g.insert_edge(2, 3, 1.0);
+		auto const before = g;
+		auto const order = g.topo_order();
+		auto const message = "Cannot call gdwg::graph<N, E>::insert_edge when the edge would create "
+		                     "a cycle in the topological order";
+		CHECK_THROWS_WITH(g.insert_edge(3, 1, 1.0), message);
+		CHECK_THROWS_WITH(g.insert_edge(2, 1, 9.0), message);
+		CHECK_THROWS_WITH(g.insert_edge(4, 4, 1.0), message);
+		CHECK(g == before);
+		CHECK(g.topo_order() == order);
+		g.insert_edge(1, 3, 2.0); // a shortcut is not a cycle
+		CHECK(is_topological(g));
+	}
+	SECTION("new and erased nodes") {
+		g.insert_edge(2, 1, 1.0);
+		g.insert_node(0);
+		g.insert_edge(0, 2, 1.0);
+		CHECK(is_topological(g));
+		CHECK(g.erase_node(2));
+		CHECK(g.erase_node(3));
+		CHECK(g.erase_node(4));
+		CHECK(is_topological(g));
+		g.insert_edge(1, 0, 1.0);
+		CHECK(g.topo_order() == std::vector<int>{5, 1, 0});
+		g.clear();
+		CHECK(g.has_topological_order());
+		CHECK(g.topo_order().empty());
+	}
+	SECTION("merge_replace_node") {
+		g.insert_edge(3, 4, 1.0);
+		g.insert_edge(5, 1, 1.0);
+		g.insert_edge(1, 2, 1.0);
+		CHECK_THROWS_WITH(g.merge_replace_node(5, 2),
+		                  "Cannot call gdwg::graph<N, E>::merge_replace_node when the merge would "
+		                  "create a cycle in the topological order");
+		CHECK_THROWS(g.merge_replace_node(2, 5));
+		CHECK(g.is_node(5));
+		// 2 and 3 are unrelated, and merging them joins the two chains into 5 -> 1 -> 3 -> 4
+		g.merge_replace_node(2, 3);
+		CHECK(g.is_connected(1, 3));
+		CHECK(g.topo_order() == std::vector<int>{5, 1, 3, 4});
+	}
+	SECTION("copies keep their own order") {
+		g.insert_edge(2, 1, 1.0);
+		auto copy = g;
+		copy.insert_edge(1, 3, 1.0);
+		copy.insert_edge(3, 5, 1.0);
+		CHECK(is_topological(copy));
+		CHECK(is_topological(g));
+		CHECK(!g.is_connected(1, 3));
+		auto moved = std::move(copy);
+		CHECK(moved.has_topological_order());
+		CHECK(is_topological(moved));
+		g.disable_topological_order();
+		g.insert_edge(1, 2, 1.0); // cycles are allowed again
+		CHECK(!g.has_topological_order());
+	}
+}
+
+TEST_CASE("topological order 3 (many random insertions)") {
+	// the first edges all go from a higher key to a lower one, so none can close a cycle, but they
+	// keep contradicting the order the nodes were inserted in
+	using graph = gdwg::graph<int, int>;
+	auto g = graph{};
+	for (auto i = 0; i < 300; ++i) {
+		g.insert_node(i);
+	}
+	g.enable_topological_order();
+	auto rejected = 0;
+	for (auto i = 0; i < 3000; ++i) {
+		auto const a = (i * 7919) % 300;
+		auto const b = (i * 104729 + 13) % 300;
+		if (a < b) {
+			g.insert_edge(b, a, i);
+		}
+		else if (b < a) {
+			g.insert_edge(a, b, i);
+		}
+	}
+	CHECK(is_topological(g));
+	for (auto i = 0; i < 300; i += 7) {
+		g.erase_node(i);
+	}
+	CHECK(is_topological(g));
+	// an edge from a lower key to a higher one closes a cycle if there is already a path back
+	for (auto i = 0; i < 200; ++i) {
+		auto const a = (i * 31) % 300;
+		auto const b = (i * 17 + 5) % 300;
+		if (a == b or !g.is_node(a) or !g.is_node(b)) {
+			continue;
+		}
+		try {
+			g.insert_edge(std::min(a, b), std::max(a, b), -i);
+		} catch (std::runtime_error const&) {
+			++rejected;
+		}
+	}
+	CHECK(is_topological(g));
+	CHECK(rejected > 0);
+}
@@ -0,0 +1,94 @@
+#include "gdwg/algorithms/components.hpp"
+#include "gdwg/algorithms/spanning_forest.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ========================
+// MINIMUM SPANNING FOREST
+// ------------------------
+
+namespace {
+	template<typename E>
+	auto total_weight(std::vector<gdwg::algorithms::forest_edge<E>> const& edges) -> E {
+		auto total = E{};
+		for (auto const& e : edges) {
+			total += e.weight;
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("minimum_spanning_forest") {
+	using gdwg::algorithms::mst_algorithm;
+	SECTION("edge direction is ignored and the lightest parallel edge is used") {
+		using graph = gdwg::graph<char, int>;
+		auto const v = std::vector<graph::value_type>{{'a', 'b', 4},
+		                                              {'b', 'a', 9},
+		                                              {'b', 'c', 2},
+		                                              {'c', 'a', 7},
+		                                              {'c', 'd', 8},
+		                                              {'c', 'd', 1},
+		                                              {'d', 'd', 0},
+		                                              {'a', 'd', 3}};
+		auto const g = graph(v.begin(), v.end());
+		for (auto const algorithm : {mst_algorithm::kruskal, mst_algorithm::boruvka}) {
+			auto const forest = gdwg::algorithms::minimum_spanning_forest(g, algorithm);
+			auto out = std::ostringstream{};
+			out << forest;
+			auto const expected_output = std::string_view(R"(a (
+  d | 3
+)
+b (
+  c | 2
+)
+c (
+  d | 1
+)
+d (
+)
+)");
+			CHECK(out.str() == expected_output);
+		}
+	}
+	SECTION("one tree per weakly connected component, isolated nodes kept") {
+		using graph = gdwg::graph<std::string, double>;
+		auto const v = std::vector<graph::value_type>{{"x", "y", 1.5},
+		                                              {"y", "z", 0.5},
+		                                              {"x", "z", 0.25},
+		                                              {"p", "q", -2.0}};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("lonely");
+		auto const forest = gdwg::algorithms::minimum_spanning_forest(g);
+		CHECK(forest.nodes() == g.nodes());
+		CHECK(forest.weights("p", "q") == std::vector<double>{-2.0});
+		CHECK(forest.weights("x", "z") == std::vector<double>{0.25});
+		CHECK(forest.weights("y", "z") == std::vector<double>{0.5});
+		CHECK(!forest.is_connected("x", "y"));
+		CHECK(forest.connections("lonely").empty());
+	}
+	SECTION("Kruskal and Boruvka agree on a larger graph") {
+		using graph = gdwg::graph<int, int>;
+		auto v = std::vector<graph::value_type>{};
+		for (auto i = 0; i < 20000; ++i) {
+			// few distinct weights, so most of the work is tie breaking
+			v.push_back({(i * 7919) % 3000, (i * 104723) % 3001, (i * 31) % 17});
+		}
+		auto const f = graph(v.begin(), v.end()).freeze();
+		auto pool = gdwg::thread_pool(4);
+		auto const kruskal = gdwg::algorithms::minimum_spanning_edges(f, mst_algorithm::kruskal);
+		auto const boruvka =
+		   gdwg::algorithms::minimum_spanning_edges(f, mst_algorithm::boruvka, pool);
+		CHECK(kruskal == boruvka);
+		CHECK(total_weight(kruskal) == total_weight(boruvka));
+		CHECK(kruskal.size() + gdwg::algorithms::wcc(f).count == f.size());
+	}
+	SECTION("empty graph and graph without edges") {
+		auto const g = gdwg::graph<int, int>{1, 2, 3};
+		CHECK(gdwg::algorithms::minimum_spanning_forest(g) == g);
+		CHECK(gdwg::algorithms::minimum_spanning_forest(gdwg::graph<int, int>{}).empty());
+	}
+}